@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Generate src/MinBlepTables.hpp.
+
+Builds minimum-phase band-limited step (MinBLEP) tables with the same method as
+Rack's dsp::minBlepImpulse(): a Blackman-Harris windowed sinc with Z zero
+crossings per side, sampled O times per sample, made minimum-phase through the
+real cepstrum, then integrated and normalized. Computed in double precision,
+and with the cepstrum zero-padded CEPSTRUM_PADDING times: without padding the
+minimum-phase impulse wraps around, which leaves the step short of 1 before
+its last point (a 0.2 jump at Z = 4, 0.001 at Z = 16).
+
+Each table is stored as the residual (step - 1) in a polyphase layout
+[O + 1][2 * Z]: row k holds the residual at sample offsets j + k / O for
+j = 0 .. 2Z - 1, so inserting a step reads two contiguous rows and blends them.
+Row O is row 0 advanced by one sample, which saves a bounds check.
+
+Usage: python3 scripts/generate_minblep_tables.py > src/MinBlepTables.hpp
+(or `make minblep-tables`)
+"""
+
+import cmath
+import math
+import sys
+
+# (zero crossings, oversampling) per quality setting, lowest first
+FAMILIES = [(4, 16), (8, 16), (16, 16)]
+CEPSTRUM_PADDING = 8
+
+
+def fft(x, inverse=False):
+    n = len(x)
+    if n == 1:
+        return list(x)
+    even = fft(x[0::2], inverse)
+    odd = fft(x[1::2], inverse)
+    sign = 1 if inverse else -1
+    out = [0j] * n
+    for k in range(n // 2):
+        t = cmath.exp(sign * 2j * math.pi * k / n) * odd[k]
+        out[k] = even[k] + t
+        out[k + n // 2] = even[k] - t
+    return out
+
+
+def ifft(x):
+    n = len(x)
+    return [v / n for v in fft(x, inverse=True)]
+
+
+def sinc(x):
+    if x == 0.0:
+        return 1.0
+    x *= math.pi
+    return math.sin(x) / x
+
+
+def blackman_harris(p):
+    return (0.35875 - 0.48829 * math.cos(2 * math.pi * p)
+            + 0.14128 * math.cos(4 * math.pi * p)
+            - 0.01168 * math.cos(6 * math.pi * p))
+
+
+def minblep_step(z, o):
+    """Band-limited step, 2*z*o + 1 points from 0 to 1."""
+    n = 2 * z * o
+    padded = n * CEPSTRUM_PADDING
+    x = []
+    for i in range(n):
+        p = -z + 2.0 * z * i / (n - 1)
+        x.append(complex(sinc(p) * blackman_harris(i / (n - 1))))
+    x += [0j] * (padded - n)
+
+    # Real cepstrum, folded to make the spectrum minimum-phase
+    spectrum = fft(x)
+    cepstrum = ifft([complex(math.log(max(abs(v), 1e-300))) for v in spectrum])
+    for i in range(1, padded // 2):
+        cepstrum[i] *= 2.0
+        cepstrum[padded - i] = 0j
+    impulse = ifft([cmath.exp(v) for v in fft(cepstrum)])[:n]
+
+    # Integrate the impulse into a step and normalize its final value to 1
+    step = []
+    total = 0.0
+    for v in impulse:
+        total += v.real
+        step.append(total)
+    step = [v / step[-1] for v in step]
+    step.append(1.0)
+    return step
+
+
+def format_row(values):
+    return ", ".join("%.9ef" % v for v in values)
+
+
+def main():
+    out = sys.stdout
+    out.write("// Generated by scripts/generate_minblep_tables.py - do not edit.\n")
+    out.write("// MinBLEP residual tables (step - 1) in polyphase layout [O + 1][2 * Z].\n")
+    out.write("#pragma once\n\n")
+    names = []
+    for z, o in FAMILIES:
+        step = minblep_step(z, o)
+        name = "MINBLEP_Z%d_O%d" % (z, o)
+        names.append((name, z, o))
+        out.write("alignas(64) static const float %s[%d][%d] = {\n" % (name, o + 1, 2 * z))
+        for k in range(o + 1):
+            row = [step[j * o + k] - 1.0 for j in range(2 * z)]
+            out.write("\t{%s},\n" % format_row(row))
+        out.write("};\n\n")
+
+    out.write("struct MinBlepKernel {\n")
+    out.write("\tint z;  // Zero crossings (step length is 2 * z samples)\n")
+    out.write("\tint o;  // Phases per sample\n")
+    out.write("\tconst float* table;  // [o + 1][2 * z]\n")
+    out.write("};\n\n")
+    out.write("static const MinBlepKernel MINBLEP_KERNELS[] = {\n")
+    for name, z, o in names:
+        out.write("\t{%d, %d, &%s[0][0]},\n" % (z, o, name))
+    out.write("};\n")
+    out.write("static constexpr int MINBLEP_KERNEL_COUNT = %d;\n" % len(names))
+    out.write("static constexpr int MINBLEP_MAX_Z = %d;\n" % max(z for z, o in FAMILIES))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,265 @@
+#include "CvCapture.hpp"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+
+enum FrameFlags : uint8_t {
+	FRAME_PARAMS = 1 << 0,
+	FRAME_INPUTS = 1 << 1,
+	FRAME_HARD_SYNC = 1 << 2,
+};
+
+
+uint32_t fnv1a(const void* data, size_t size, uint32_t hash) {
+	const uint8_t* bytes = (const uint8_t*)data;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+
+CvRecorder::~CvRecorder() {
+	// The engine no longer calls process(), so the audio-side state is ours
+	if (active)
+		endStream();
+	finished.store(true, std::memory_order_release);
+	joinWriter();
+	delete ring;
+}
+
+
+bool CvRecorder::start(const std::string& path, const CvCaptureHeader& header, std::string& error) {
+	if (recording.load(std::memory_order_acquire) || active) {
+		error = "A recording is already running";
+		return false;
+	}
+	if (writer.joinable() && !finished.load(std::memory_order_acquire)) {
+		error = "The previous recording is still being written";
+		return false;
+	}
+	joinWriter();
+
+	file = std::fopen(path.c_str(), "wb");
+	if (!file) {
+		error = "Could not open " + path + " for writing";
+		return false;
+	}
+	if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+		std::fclose(file);
+		file = nullptr;
+		error = "Could not write " + path;
+		return false;
+	}
+	if (!ring)
+		ring = new SpscRing<Chunk, 16>;
+	numParams = header.numParams;
+	numInputs = header.numInputs;
+	overrun.store(false);
+	framesRecorded.store(0);
+	finished.store(false);
+	writer = std::thread(&CvRecorder::writerLoop, this);
+	recording.store(true, std::memory_order_release);
+	return true;
+}
+
+
+void CvRecorder::recordInputs(const std::vector<engine::Param>& params, const std::vector<engine::Input>& inputs, bool hardSync) {
+	if (!active) {
+		active = true;
+		first = true;
+		chunk = nullptr;
+	}
+	if (!reserve(MAX_RECORD_BYTES)) {
+		overrun.store(true, std::memory_order_release);
+		recording.store(false, std::memory_order_release);
+		endStream();
+		return;
+	}
+
+	uint8_t* flags = &chunk->data[chunk->size];
+	*flags = hardSync ? FRAME_HARD_SYNC : 0;
+	chunk->size++;
+
+	uint64_t paramMask = 0;
+	for (int i = 0; i < numParams; i++) {
+		float value = params[i].value;
+		if (first || std::memcmp(&value, &lastParams[i], sizeof(float)) != 0)
+			paramMask |= uint64_t(1) << i;
+	}
+	if (paramMask) {
+		*flags |= FRAME_PARAMS;
+		append(&paramMask, sizeof(paramMask));
+		for (int i = 0; i < numParams; i++) {
+			if (paramMask & (uint64_t(1) << i)) {
+				lastParams[i] = params[i].value;
+				append(&lastParams[i], sizeof(float));
+			}
+		}
+	}
+
+	uint32_t inputMask = 0;
+	for (int i = 0; i < numInputs; i++) {
+		const engine::Input& input = inputs[i];
+		if (first || input.channels != lastChannels[i]
+		    || std::memcmp(input.voltages, lastVoltages[i], input.channels * sizeof(float)) != 0)
+			inputMask |= uint32_t(1) << i;
+	}
+	if (inputMask) {
+		*flags |= FRAME_INPUTS;
+		append(&inputMask, sizeof(inputMask));
+		for (int i = 0; i < numInputs; i++) {
+			if (!(inputMask & (uint32_t(1) << i)))
+				continue;
+			const engine::Input& input = inputs[i];
+			lastChannels[i] = input.channels;
+			std::memcpy(lastVoltages[i], input.voltages, input.channels * sizeof(float));
+			append(&lastChannels[i], 1);
+			append(lastVoltages[i], input.channels * sizeof(float));
+		}
+	}
+	first = false;
+}
+
+
+void CvRecorder::recordOutputHash(uint32_t hash) {
+	// recordInputs() reserved room for the hash
+	append(&hash, sizeof(hash));
+	framesRecorded.store(framesRecorded.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+
+void CvRecorder::endStream() {
+	if (chunk && chunk->size > 0)
+		ring->produce();
+	chunk = nullptr;
+	active = false;
+	finished.store(true, std::memory_order_release);
+}
+
+
+bool CvRecorder::reserve(int bytes) {
+	if (chunk && chunk->size + bytes <= (uint32_t)CHUNK_BYTES)
+		return true;
+	if (chunk)
+		ring->produce();
+	chunk = ring->producerSlot();
+	if (!chunk)
+		return false;
+	chunk->size = 0;
+	return true;
+}
+
+
+void CvRecorder::append(const void* data, int bytes) {
+	std::memcpy(&chunk->data[chunk->size], data, bytes);
+	chunk->size += bytes;
+}
+
+
+void CvRecorder::writerLoop() {
+	while (true) {
+		// Read the flag first: everything published before it is drained below
+		bool done = finished.load(std::memory_order_acquire);
+		while (const Chunk* c = ring->consumerSlot()) {
+			std::fwrite(c->data, 1, c->size, file);
+			ring->consume();
+		}
+		if (done)
+			break;
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+	std::fclose(file);
+	file = nullptr;
+}
+
+
+void CvRecorder::joinWriter() {
+	if (writer.joinable())
+		writer.join();
+}
+
+
+bool CvReplay::load(const std::string& path, std::string& error) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		error = "Could not open " + path;
+		return false;
+	}
+	file.read((char*)&header, sizeof(header));
+	if (!file || std::memcmp(header.magic, "HQCV", 4) != 0) {
+		error = "Not a HydraQuartet capture file";
+		return false;
+	}
+	if (header.version != CvCaptureHeader().version) {
+		error = "Unsupported capture version " + std::to_string(header.version);
+		return false;
+	}
+	if (header.numParams > CV_CAPTURE_MAX_PARAMS || header.numInputs > CV_CAPTURE_MAX_INPUTS) {
+		error = "Capture has too many params or inputs";
+		return false;
+	}
+	data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	rewind();
+	return true;
+}
+
+
+void CvReplay::rewind() {
+	pos = 0;
+	frames = 0;
+	mismatches = 0;
+	firstMismatch = -1;
+	std::memset(params, 0, sizeof(params));
+	std::memset(voltages, 0, sizeof(voltages));
+	std::memset(channels, 0, sizeof(channels));
+	hardSync = false;
+}
+
+
+bool CvReplay::read(void* out, size_t bytes) {
+	if (pos + bytes > data.size())
+		return false;
+	std::memcpy(out, &data[pos], bytes);
+	pos += bytes;
+	return true;
+}
+
+
+bool CvReplay::nextFrame() {
+	uint8_t flags;
+	if (!read(&flags, 1))
+		return false;
+	hardSync = (flags & FRAME_HARD_SYNC) != 0;
+
+	if (flags & FRAME_PARAMS) {
+		uint64_t mask;
+		if (!read(&mask, sizeof(mask)))
+			return false;
+		for (int i = 0; i < header.numParams; i++) {
+			if ((mask & (uint64_t(1) << i)) && !read(&params[i], sizeof(float)))
+				return false;
+		}
+	}
+
+	if (flags & FRAME_INPUTS) {
+		uint32_t mask;
+		if (!read(&mask, sizeof(mask)))
+			return false;
+		for (int i = 0; i < header.numInputs; i++) {
+			if (!(mask & (uint32_t(1) << i)))
+				continue;
+			if (!read(&channels[i], 1) || channels[i] > 16)
+				return false;
+			if (!read(voltages[i], channels[i] * sizeof(float)))
+				return false;
+		}
+	}
+
+	if (!read(&expectedHash, sizeof(expectedHash)))
+		return false;
+	frames++;
+	return true;
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include "plugin.hpp"
+#include "Telemetry.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+// Capture and replay of a module's input and parameter streams
+//
+// File layout (little-endian, native float):
+//   CvCaptureHeader
+//   one record per engine frame:
+//     uint8  flags          FRAME_PARAMS | FRAME_INPUTS | FRAME_HARD_SYNC
+//     if FRAME_PARAMS: uint64 mask, then one float per set bit (changed params)
+//     if FRAME_INPUTS: uint32 mask, then per set bit: uint8 channels, float[channels]
+//     uint32 output hash   (FNV-1a of the module's outputs after process())
+// The first record holds every param and input, later ones only what changed,
+// so static knobs and cables cost one byte plus the hash per frame.
+// FRAME_HARD_SYNC marks frames where the profiler's stress scenario forced
+// both sync switches to Hard.
+
+struct CvCaptureHeader {
+	char magic[4] = {'H', 'Q', 'C', 'V'};
+	uint32_t version = 2;
+	float sampleRate = 0.f;
+	int32_t blockSize = 0;        // Render settings that change the output
+	uint8_t internalRate = 0;
+	uint8_t minBlepQuality = 0;
+	uint8_t reserved[2] = {};
+	uint32_t tuningHash = 0;
+	uint16_t numParams = 0;
+	uint16_t numInputs = 0;
+};
+static_assert(sizeof(CvCaptureHeader) == 28, "CvCaptureHeader must be packed");
+
+static constexpr int CV_CAPTURE_MAX_PARAMS = 64;
+static constexpr int CV_CAPTURE_MAX_INPUTS = 32;
+
+uint32_t fnv1a(const void* data, size_t size, uint32_t hash = 2166136261u);
+
+
+// Records frames on the audio thread into a chunk ring; a writer thread streams
+// full chunks to disk. The audio thread never blocks or allocates: if the writer
+// falls behind and the ring fills up, recording stops and reports an overrun.
+struct CvRecorder {
+	static constexpr int CHUNK_BYTES = 1 << 16;
+	// Largest possible record: all params and all 16-channel inputs changed
+	static constexpr int MAX_RECORD_BYTES = 1 + 8 + 4 * CV_CAPTURE_MAX_PARAMS
+		+ 4 + CV_CAPTURE_MAX_INPUTS * (1 + 4 * 16) + 4;
+
+	struct Chunk {
+		uint32_t size;
+		uint8_t data[CHUNK_BYTES];
+	};
+
+	// UI -> audio: capture frames while set
+	std::atomic<bool> recording{false};
+	// Audio -> UI: ring overflowed and recording stopped
+	std::atomic<bool> overrun{false};
+	std::atomic<uint64_t> framesRecorded{0};
+
+	~CvRecorder();
+
+	// UI thread
+	bool start(const std::string& path, const CvCaptureHeader& header, std::string& error);
+	void stop() {
+		recording.store(false, std::memory_order_release);
+	}
+
+	// Audio thread, while `recording` is set
+	// The first call after start() begins the stream (check streaming() before
+	// it to reset DSP state, so replay starts from the same state)
+	void recordInputs(const std::vector<engine::Param>& params, const std::vector<engine::Input>& inputs, bool hardSync);
+	void recordOutputHash(uint32_t hash);
+	// Publishes the last partial chunk once recording has been switched off
+	void endStream();
+	bool streaming() const {
+		return active;
+	}
+
+private:
+	SpscRing<Chunk, 16>* ring = nullptr;  // 1 MB, allocated by start()
+	std::atomic<bool> finished{false};    // Audio -> writer: last chunk published
+	std::thread writer;
+	FILE* file = nullptr;
+
+	// Audio thread state
+	bool active = false;
+	bool first = true;
+	Chunk* chunk = nullptr;
+	int numParams = 0;
+	int numInputs = 0;
+	float lastParams[CV_CAPTURE_MAX_PARAMS];
+	float lastVoltages[CV_CAPTURE_MAX_INPUTS][16];
+	uint8_t lastChannels[CV_CAPTURE_MAX_INPUTS];
+
+	bool reserve(int bytes);
+	void append(const void* data, int bytes);
+	void writerLoop();
+	void joinWriter();
+};
+
+
+// Decodes a capture loaded into memory, one frame at a time
+// Loading allocates (UI thread); nextFrame() only reads (audio thread).
+struct CvReplay {
+	CvCaptureHeader header;
+	std::vector<uint8_t> data;
+
+	// Decoded state of the current frame
+	float params[CV_CAPTURE_MAX_PARAMS];
+	float voltages[CV_CAPTURE_MAX_INPUTS][16];
+	uint8_t channels[CV_CAPTURE_MAX_INPUTS];
+	bool hardSync = false;
+	uint32_t expectedHash = 0;
+
+	uint64_t frames = 0;
+	uint64_t mismatches = 0;
+	int64_t firstMismatch = -1;
+
+	bool load(const std::string& path, std::string& error);
+	void rewind();
+	// Returns false at the end of the capture or on a truncated record
+	bool nextFrame();
+	void checkOutputHash(uint32_t hash) {
+		if (hash != expectedHash) {
+			if (mismatches == 0)
+				firstMismatch = (int64_t)frames - 1;
+			mismatches++;
+		}
+	}
+
+private:
+	size_t pos = 0;
+	bool read(void* out, size_t bytes);
+};
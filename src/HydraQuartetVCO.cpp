@@ -15,224 +15,344 @@
  */
 
 #include "plugin.hpp"
+#include "LatencyProfiler.hpp"
+#include "Resampler.hpp"
+#include "Telemetry.hpp"
+#include "CvCapture.hpp"
+#include "Tuning.hpp"
+#include "VoiceBank.hpp"
+#include <osdialog.h>
+#include <chrono>
 #include <cmath>
 #include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
 
 using simd::float_4;
 
-// Constants for MinBLEP generation
-static constexpr int MINBLEP_Z = 16;  // Zero crossings
-static constexpr int MINBLEP_O = 16;  // Oversample factor
-
-// Static MinBLEP impulse table (shared lookup, generated once)
-struct MinBlepTable {
-	float impulse[2 * MINBLEP_Z * MINBLEP_O + 1];
+// Plugin-level renderer shared by modules with "Batch with other instances"
+// enabled. Each module hands over the voices of its last, partly filled SIMD
+// group once per engine frame (whole groups gain nothing from packing and stay
+// in the module); in the next frame the voices of all of them are rendered,
+// packed into 16-voice banks, and every module reads its own voices back. The
+// output is the render of the previous frame's controls: one sample of latency.
+// The first batched module to run in a frame sets the render up. Then every
+// batched module's thread claims banks and renders them until none are left,
+// and waits for the banks other threads claimed before reading its voices, so
+// the batch is spread over the engine threads that run batched modules.
+struct BatchEngine {
+	static constexpr int BANKS = 16;
+	static constexpr int MAX_LANES = BANKS * 16;
+	static constexpr int MAX_SLOTS = 64;
+	// Busy-wait iterations before yielding the thread
+	static constexpr int SPIN_LIMIT = 64;
+
+	struct Slot {
+		bool used = false;
+		// Controls waiting for the frame setup to (re)allocate the slot's
+		// voices; with the voices in place they go straight to nextControls
+		FrameControls ctl;
+		int ctlFirstVoice = 0;
+		bool resize = false;
+		bool overflow = false;  // Not enough free voices
+		int lanes[4];           // Batch voice per slot voice
+		int laneCount = 0;
+		// Module voice of the slot's first voice, in nextControls and in the
+		// render in progress (the start of a group when the slot has voices)
+		int firstVoice = 0;
+		int renderedFirstVoice = 0;
+	};
 
-	MinBlepTable() {
-		dsp::minBlepImpulse(MINBLEP_Z, MINBLEP_O, impulse);
-		impulse[2 * MINBLEP_Z * MINBLEP_O] = 1.f;
+	VoiceBank banks[BANKS];
+	// Controls for the next render, written by the modules during the frame
+	FrameControls nextControls[BANKS];
+	// Controls of the render in progress
+	FrameControls bankControls[BANKS];
+	OutputFrame bankFrames[BANKS];
+	int laneOwner[MAX_LANES];  // Slot, -1 = free
+	Slot slots[MAX_SLOTS];
+	FrequencyTable defaultTable;  // For voices no module owns
+	// Held for slot and voice bookkeeping, the controls and the frame setup,
+	// not the render
+	std::atomic_flag lock = ATOMIC_FLAG_INIT;
+	int64_t renderedFrame = -1;
+	bool lanesChanged = false;  // Banks to render need recounting
+
+	// This frame's render: banks are claimed in order by nextBank
+	int bankChannels[BANKS] = {};
+	int frameBanks[BANKS];
+	int frameBankCount = 0;
+	float frameSampleTime = 0.f;
+	float frameSampleRate = 0.f;
+	std::atomic<int> nextBank{0};
+	std::atomic<int> banksDone{0};
+	// Renders set up (lock held) and finished, for leave()
+	int64_t framesSetUp = 0;
+	std::atomic<int64_t> framesRendered{0};
+
+	// Room left, for modules waiting to retry after the batch was full
+	std::atomic<int> freeLanes{MAX_LANES};
+	std::atomic<int> freeSlots{MAX_SLOTS};
+
+	BatchEngine() {
+		defaultTable.build12Tet();
+		std::memset(nextControls, 0, sizeof(nextControls));
+		for (int lane = 0; lane < MAX_LANES; lane++) {
+			laneOwner[lane] = -1;
+			nextControls[lane / 16].freqTable[lane % 16] = &defaultTable;
+			nextControls[lane / 16].minBlep[lane % 16] = &MINBLEP_KERNELS[0];
+		}
 	}
-};
-static MinBlepTable minBlepTable;
-
-// SIMD-compatible MinBLEP buffer with stride support
-// Stores 4 interleaved lanes for efficient SIMD processing
-template <int N>
-struct MinBlepBuffer {
-	float_4 buffer[2 * N] = {};
-	int pos = 0;
-
-	// Insert discontinuity with stride=4 for a single lane
-	// p: subsample position (-1 < p <= 0)
-	// x: discontinuity magnitude
-	// lane: which SIMD lane (0-3)
-	void insertDiscontinuity(float p, float x, int lane) {
-		if (!(-1.f < p && p <= 0.f))
-			return;
-		for (int j = 0; j < 2 * MINBLEP_Z; j++) {
-			float minBlepIndex = ((float)j - p) * MINBLEP_O;
-			int index = (pos + j) % (2 * N);
-			// Access specific lane using array indexing
-			buffer[index][lane] += x * (-1.f + math::interpolateLinear(minBlepTable.impulse, minBlepIndex));
+
+	// Shared instance, alive while any module exists (UI thread)
+	static BatchEngine* acquire();
+	static void release();
+
+	// Audio thread
+	// Returns a slot for the calling module, or -1 if every slot is taken
+	int join() {
+		spinLock();
+		int s = 0;
+		while (s < MAX_SLOTS && slots[s].used)
+			s++;
+		if (s < MAX_SLOTS) {
+			Slot& slot = slots[s];
+			slot.used = true;
+			slot.resize = false;
+			slot.overflow = false;
+			slot.laneCount = 0;
+			slot.firstVoice = 0;
+			slot.renderedFirstVoice = 0;
+			freeSlots--;
 		}
+		spinUnlock();
+		return (s < MAX_SLOTS) ? s : -1;
 	}
 
-	float_4 process() {
-		float_4 v = buffer[pos];
-		buffer[pos] = float_4(0.f);
-		pos = (pos + 1) % (2 * N);
-		return v;
+	// Also called from the module destructor, while other modules are running
+	void leave(int s) {
+		spinLock();
+		allocateLanes(s, 0);
+		slots[s].used = false;
+		freeSlots++;
+		int64_t frame = framesSetUp;
+		spinUnlock();
+		// The render in progress may still read the slot's tuning table; later
+		// ones are set up without it
+		int spins = 0;
+		while (framesRendered.load(std::memory_order_acquire) < frame)
+			backOff(spins);
 	}
-};
 
-// VcoEngine: Reusable oscillator DSP with SIMD state
-// Encapsulates all per-oscillator state for dual VCO architecture
-struct VcoEngine {
-	float_4 phase[4] = {};
-	float_4 oldPhase[4] = {};
-	float_4 deltaPhase[4] = {};
-	MinBlepBuffer<32> sawMinBlepBuffer[4];
-	MinBlepBuffer<32> sqrMinBlepBuffer[4];
-	MinBlepBuffer<32> triMinBlepBuffer[4];
-	MinBlepBuffer<32> xorMinBlepBuffer[4];  // XOR discontinuity tracking
-
-	// Process one SIMD group (4 voices), returns 4 waveforms via output parameters
-	// g: SIMD group index (0-3)
-	// freq: frequency for 4 voices
-	// sampleTime: 1/sampleRate
-	// pwm: pulse width for 4 voices
-	// wrapMask: output parameter indicating which lanes wrapped
-	// sqr1Input: square wave from VCO1 (for XOR calculation in VCO2)
-	// xorOut: optional XOR output pointer
-	void process(int g, float_4 freq, float sampleTime, float_4 pwm,
-	             float_4& saw, float_4& sqr, float_4& tri, float_4& sine,
-	             int& wrapMask,
-	             float_4 sqr1Input = float_4(0.f),  // Square from VCO1 (for XOR)
-	             float_4* xorOut = nullptr) {        // Optional XOR output
-		// Phase accumulation with SIMD
-		deltaPhase[g] = simd::clamp(freq * sampleTime, 0.f, 0.49f);
-		oldPhase[g] = phase[g];
-		phase[g] += deltaPhase[g];
-
-		// Detect phase wrap
-		float_4 wrapped = phase[g] >= 1.f;
-		phase[g] -= simd::floor(phase[g]);  // Handles large FM jumps
-
-		// === SAWTOOTH with strided MinBLEP ===
-		wrapMask = simd::movemask(wrapped);
-		if (wrapMask) {
-			for (int i = 0; i < 4; i++) {
-				if ((wrapMask & (1 << i)) && deltaPhase[g][i] > 0.f) {
-					float subsample = (1.f - oldPhase[g][i]) / deltaPhase[g][i] - 1.f;
-					sawMinBlepBuffer[g].insertDiscontinuity(subsample, -2.f, i);
-				}
-			}
+	// Whether a module with this many voices would fit (a hint: other modules
+	// may take the room before it joins)
+	bool hasRoom(int channels) const {
+		return freeSlots.load(std::memory_order_relaxed) > 0
+			&& freeLanes.load(std::memory_order_relaxed) >= channels;
+	}
+
+	// Once per engine frame for each batched module: writes the module's batch
+	// voices rendered from its previous controls into their group of `out`
+	// (channels = how many, 0 before the first render) and queues voices
+	// firstVoice and up of `ctl` (at most 4, starting a group) for the next
+	// frame. Sets up the frame's render if this is the first module of the
+	// frame, and helps render it. False if the batch ran out of voices.
+	bool exchange(int s, int64_t frame, float sampleTime, float sampleRate,
+	              const FrameControls& ctl, int firstVoice, OutputFrame& out, int& channels) {
+		spinLock();
+		if (frame != renderedFrame) {
+			setUpFrame(sampleTime, sampleRate);
+			renderedFrame = frame;
 		}
-		saw = 2.f * phase[g] - 1.f + sawMinBlepBuffer[g].process();
-
-		// === SQUARE with PWM using strided MinBLEP ===
-		// Falling edge detection (phase crosses PWM threshold)
-		float_4 fallingEdge = (oldPhase[g] < pwm) & (phase[g] >= pwm);
-		int fallMask = simd::movemask(fallingEdge);
-		if (fallMask) {
-			for (int i = 0; i < 4; i++) {
-				if ((fallMask & (1 << i)) && deltaPhase[g][i] > 0.f) {
-					float subsample = (pwm[i] - oldPhase[g][i]) / deltaPhase[g][i] - 1.f;
-					sqrMinBlepBuffer[g].insertDiscontinuity(subsample, -2.f, i);
-				}
-			}
+		Slot& slot = slots[s];
+		bool ok = !slot.overflow;
+		// The banks already hold this frame's controls
+		if (ok && ctl.channels - firstVoice == slot.laneCount && firstVoice == slot.firstVoice) {
+			scatter(slot, ctl);
 		}
-
-		// Rising edge on wrap
-		if (wrapMask) {
-			for (int i = 0; i < 4; i++) {
-				if ((wrapMask & (1 << i)) && deltaPhase[g][i] > 0.f) {
-					float subsample = (1.f - oldPhase[g][i]) / deltaPhase[g][i] - 1.f;
-					sqrMinBlepBuffer[g].insertDiscontinuity(subsample, 2.f, i);
-				}
-			}
+		else {
+			slot.ctl = ctl;
+			slot.ctlFirstVoice = firstVoice;
+			slot.resize = true;
 		}
+		spinUnlock();
 
-		sqr = simd::ifelse(phase[g] < pwm, 1.f, -1.f) + sqrMinBlepBuffer[g].process();
+		renderBanks();
+		gather(slot, out);
+		channels = slot.laneCount;
+		return ok;
+	}
 
-		// === XOR ring modulation (only if requested) ===
-		if (xorOut != nullptr) {
-			// Raw ring modulation: sqr1 * sqr2
-			*xorOut = sqr1Input * sqr;
+private:
+	// Pause, then yield once spinning has gone on for a while
+	static void backOff(int& spins) {
+		if (spins++ < SPIN_LIMIT)
+			_mm_pause();
+		else
+			std::this_thread::yield();
+	}
 
-			// Track XOR edges from THIS oscillator's square transitions
-			// (sqr1Input edges are tracked separately in VCO1's call)
+	void spinLock() {
+		int spins = 0;
+		while (lock.test_and_set(std::memory_order_acquire))
+			backOff(spins);
+	}
+	void spinUnlock() {
+		lock.clear(std::memory_order_release);
+	}
 
-			// Falling edge detection (PWM threshold crossing)
-			// When sqr transitions from +1 to -1, XOR changes by -2 * sqr1Input
-			if (fallMask) {
-				for (int i = 0; i < 4; i++) {
-					if ((fallMask & (1 << i)) && deltaPhase[g][i] > 0.f) {
-						float subsample = (pwm[i] - oldPhase[g][i]) / deltaPhase[g][i] - 1.f;
-						float xorDisc = -2.f * sqr1Input[i];  // sqr: +1 -> -1
-						xorMinBlepBuffer[g].insertDiscontinuity(subsample, xorDisc, i);
-					}
-				}
+	// Grow or shrink a slot's voices, taking the lowest free ones so the
+	// batch stays packed into as few groups as possible (lock held)
+	bool allocateLanes(int s, int count) {
+		Slot& slot = slots[s];
+		if (slot.laneCount != count)
+			lanesChanged = true;
+		while (slot.laneCount > count) {
+			int lane = slot.lanes[--slot.laneCount];
+			laneOwner[lane] = -1;
+			// The module's tuning table may go away with it
+			nextControls[lane / 16].freqTable[lane % 16] = &defaultTable;
+			nextControls[lane / 16].minBlep[lane % 16] = &MINBLEP_KERNELS[0];
+			freeLanes++;
+		}
+		int lane = 0;
+		bool ok = true;
+		while (slot.laneCount < count) {
+			while (lane < MAX_LANES && laneOwner[lane] >= 0)
+				lane++;
+			if (lane == MAX_LANES) {
+				ok = false;
+				break;
 			}
+			laneOwner[lane] = s;
+			// Seeded by the module's voice, as in the module's own bank
+			banks[lane / 16].resetLane(lane % 16, slot.firstVoice + slot.laneCount);
+			slot.lanes[slot.laneCount++] = lane;
+			freeLanes--;
+		}
+		return ok;
+	}
 
-			// Rising edge on wrap (when phase wraps, sqr goes from -1 to +1)
-			if (wrapMask) {
-				for (int i = 0; i < 4; i++) {
-					if ((wrapMask & (1 << i)) && deltaPhase[g][i] > 0.f) {
-						float subsample = (1.f - oldPhase[g][i]) / deltaPhase[g][i] - 1.f;
-						float xorDisc = 2.f * sqr1Input[i];  // sqr: -1 -> +1
-						xorMinBlepBuffer[g].insertDiscontinuity(subsample, xorDisc, i);
-					}
+	// Write a module's controls into its voices' next controls (lock held)
+	void scatter(const Slot& slot, const FrameControls& ctl) {
+		for (int v = 0; v < slot.laneCount; v++) {
+			int lane = slot.lanes[v];
+			nextControls[lane / 16].copyLane(lane % 16, ctl, slot.firstVoice + v);
+		}
+	}
+
+	// Allocate voices for resized modules, then copy the next controls of
+	// every bank in use for the render (lock held, no render in progress)
+	void setUpFrame(float sampleTime, float sampleRate) {
+		for (int s = 0; s < MAX_SLOTS; s++) {
+			Slot& slot = slots[s];
+			if (!slot.used)
+				continue;
+			if (slot.resize) {
+				slot.resize = false;
+				// Voices that move to other module voices start afresh
+				if (slot.ctlFirstVoice != slot.firstVoice)
+					allocateLanes(s, 0);
+				slot.firstVoice = slot.ctlFirstVoice;
+				if (slot.overflow || !allocateLanes(s, slot.ctl.channels - slot.firstVoice)) {
+					allocateLanes(s, 0);
+					slot.overflow = true;
+				}
+				else {
+					scatter(slot, slot.ctl);
 				}
 			}
+			slot.renderedFirstVoice = slot.firstVoice;
+		}
 
-			// Apply MinBLEP correction
-			*xorOut += xorMinBlepBuffer[g].process();
-		}
-
-		// === TRIANGLE via direct calculation (normalized to ±1) ===
-		// Triangle from phase: rises 0->0.5, falls 0.5->1
-		tri = simd::ifelse(phase[g] < 0.5f,
-			4.f * phase[g] - 1.f,           // -1 to +1 as phase goes 0 to 0.5
-			3.f - 4.f * phase[g]);          // +1 to -1 as phase goes 0.5 to 1
-		tri = tri + triMinBlepBuffer[g].process();
-
-		// === SINE (no antialiasing needed) ===
-		sine = simd::sin(2.f * float(M_PI) * phase[g]);
-	}
-
-	// Apply hard sync: reset phase and insert MinBLEP discontinuities
-	// Called after process() when primary oscillator wraps
-	void applySync(int g, int syncMask, float_4 primaryOldPhase, float_4 primaryDeltaPhase, float_4 pwm,
-	               float_4& saw, float_4& sqr, float_4& tri) {
-		for (int i = 0; i < 4; i++) {
-			if (!(syncMask & (1 << i))) continue;
-			if (deltaPhase[g][i] <= 0.f) continue;  // Skip if negative freq (FM)
-			if (primaryDeltaPhase[i] <= 0.f) continue;  // Skip if primary freq negative
-
-			// Calculate subsample position of primary wrap
-			float subsample = (1.f - primaryOldPhase[i]) / primaryDeltaPhase[i] - 1.f;
-			subsample = clamp(subsample, -1.f + 1e-6f, 0.f);  // Ensure valid range
-
-			// Calculate old waveform values (at current phase, before reset)
-			float currentPhase = phase[g][i];
-			float oldSaw = 2.f * currentPhase - 1.f;
-			float oldSqr = (currentPhase < pwm[i]) ? 1.f : -1.f;
-			float oldTri = (currentPhase < 0.5f)
-				? (4.f * currentPhase - 1.f)
-				: (3.f - 4.f * currentPhase);
-
-			// Reset phase to subsample-accurate position
-			float newPhase = deltaPhase[g][i] * (-subsample);
-			phase[g][i] = newPhase;
-
-			// Calculate new waveform values (at reset phase)
-			float newSaw = 2.f * newPhase - 1.f;
-			float newSqr = (newPhase < pwm[i]) ? 1.f : -1.f;
-			float newTri = (newPhase < 0.5f)
-				? (4.f * newPhase - 1.f)
-				: (3.f - 4.f * newPhase);
-
-			// Insert MinBLEP discontinuities for all geometric waveforms
-			sawMinBlepBuffer[g].insertDiscontinuity(subsample, newSaw - oldSaw, i);
-
-			// Square: only insert if value actually changed
-			if (oldSqr != newSqr) {
-				sqrMinBlepBuffer[g].insertDiscontinuity(subsample, newSqr - oldSqr, i);
+		if (lanesChanged) {
+			lanesChanged = false;
+			for (int b = 0; b < BANKS; b++)
+				bankChannels[b] = 0;
+			for (int lane = 0; lane < MAX_LANES; lane++) {
+				if (laneOwner[lane] >= 0)
+					bankChannels[lane / 16] = lane % 16 + 1;
+			}
+			frameBankCount = 0;
+			for (int b = 0; b < BANKS; b++) {
+				if (bankChannels[b] > 0)
+					frameBanks[frameBankCount++] = b;
 			}
+		}
+		for (int k = 0; k < frameBankCount; k++) {
+			int b = frameBanks[k];
+			FrameControls& ctl = bankControls[b];
+			ctl = nextControls[b];
+			ctl.channels = bankChannels[b];
+			ctl.updateFmSource((ctl.channels + 3) / 4);
+		}
+		frameSampleTime = sampleTime;
+		frameSampleRate = sampleRate;
+		framesSetUp++;
+		if (frameBankCount == 0)
+			framesRendered.store(framesSetUp, std::memory_order_release);
+		banksDone.store(0, std::memory_order_relaxed);
+		nextBank.store(0, std::memory_order_release);
+	}
 
-			// Triangle: uses dedicated triMinBlepBuffer (added in Task 1)
-			// Insert amplitude discontinuity for sync-induced phase reset
-			triMinBlepBuffer[g].insertDiscontinuity(subsample, newTri - oldTri, i);
+	// Render unclaimed banks of this frame, then wait for the claimed ones
+	// (engine threads, during the frame)
+	void renderBanks() {
+		int k;
+		while ((k = nextBank.fetch_add(1, std::memory_order_acq_rel)) < frameBankCount) {
+			int b = frameBanks[k];
+			int64_t frame = framesSetUp;
+			banks[b].render(bankControls[b], frameSampleTime, frameSampleRate, bankFrames[b]);
+			if (banksDone.fetch_add(1, std::memory_order_acq_rel) + 1 == frameBankCount)
+				framesRendered.store(frame, std::memory_order_release);
+		}
+		int spins = 0;
+		while (banksDone.load(std::memory_order_acquire) < frameBankCount)
+			backOff(spins);
+	}
 
-			// Update waveform output values for this lane to reflect synced phase
-			saw[i] = newSaw;
-			sqr[i] = newSqr;
-			tri[i] = newTri;
+	// Copy a slot's voices out of the rendered banks into their module group
+	void gather(const Slot& slot, OutputFrame& out) {
+		if (slot.laneCount == 0)
+			return;
+		int outG = slot.renderedFirstVoice / 4;
+		out.wrap1[outG] = 0;
+		out.wrap2[outG] = 0;
+		out.sync[outG] = 0;
+		for (int v = 0; v < slot.laneCount; v++) {
+			int lane = slot.lanes[v];
+			const OutputFrame& bankFrame = bankFrames[lane / 16];
+			int g = (lane % 16) / 4, i = lane % 4;
+			out.audio[outG][v] = bankFrame.audio[g][i];
+			out.sub[outG][v] = bankFrame.sub[g][i];
+			out.wrap1[outG] |= ((bankFrame.wrap1[g] >> i) & 1) << v;
+			out.wrap2[outG] |= ((bankFrame.wrap2[g] >> i) & 1) << v;
+			out.sync[outG] |= ((bankFrame.sync[g] >> i) & 1) << v;
 		}
 	}
 };
 
+static BatchEngine* batchEngine = nullptr;
+static int batchEngineRefs = 0;
+static std::mutex batchEngineMutex;
+
+BatchEngine* BatchEngine::acquire() {
+	std::lock_guard<std::mutex> guard(batchEngineMutex);
+	if (batchEngineRefs++ == 0)
+		batchEngine = new BatchEngine;
+	return batchEngine;
+}
+
+void BatchEngine::release() {
+	std::lock_guard<std::mutex> guard(batchEngineMutex);
+	if (--batchEngineRefs == 0) {
+		delete batchEngine;
+		batchEngine = nullptr;
+	}
+}
+
 // Maximum polyphony: 16 voices (4 SIMD groups of 4 voices each)
 // Arrays are sized for this limit; process() enforces bounds checking
 struct HydraQuartetVCO : Module {
@@ -270,6 +390,10 @@ struct HydraQuartetVCO : Module {
 		// Other VCO2 controls
 		SYNC2_PARAM,
 		VIBRATO2_PARAM,
+		// Vibrato LFO bank (context menu)
+		VIBRATO_RATE_PARAM,
+		VIBRATO_DELAY_PARAM,
+		VIBRATO_SPREAD_PARAM,
 		PARAMS_LEN
 	};
 	enum InputId {
@@ -322,21 +446,67 @@ struct HydraQuartetVCO : Module {
 		LIGHTS_LEN
 	};
 
-	// Dual VCO engines (each encapsulates phase, MinBLEP buffers, tri state)
-	VcoEngine vco1;
-	VcoEngine vco2;
-
-	// XOR MinBLEP tracking for VCO1 square edges (module-level, not in VcoEngine)
-	MinBlepBuffer<32> xorFromVco1MinBlep[4];  // Track VCO1 sqr transitions for XOR
-
-	// Sub-oscillator state (tracks VCO1 at -1 octave)
-	float_4 subPhase[4] = {};
-
-	// DC filters kept scalar (not in hot path, operate on mixed output)
-	dsp::TRCFilter<float> dcFilters[16];
-
-	// Vibrato LFO state (shared sine LFO at ~5.5Hz)
-	float vibratoPhase = 0.f;
+	// Oscillators, sub, DC filters and vibrato for up to 16 voices
+	VoiceBank voices;
+
+	// Tuning tables, double-buffered: each load builds freqTables[epoch & 1]
+	// and bumps tuningEpoch. The audio thread acknowledges the epoch it
+	// rendered with one frame later (batched voices render a frame late), and
+	// only then may the other table be rebuilt.
+	FrequencyTable freqTables[2];
+	std::atomic<uint32_t> tuningEpoch{0};
+	std::atomic<uint32_t> tuningAck{0};
+	uint32_t renderTuningEpoch = 0;  // Audio thread
+	// Scala sources saved with the patch (empty = 12-TET / default mapping)
+	std::string tuningScl;
+	std::string tuningKbm;
+	std::string tuningName = "12-TET";
+
+	// Per-voice scope and activity telemetry for the panel displays
+	TelemetryCapture telemetry;
+	bool scopeEnabled = true;
+
+	// Worst-case latency profiler (context menu > Diagnostics)
+	LatencyProfiler profiler;
+	bool profilerWasEnabled = false;
+
+	// Adversarial modulation driven into the inputs while profiling
+	enum StressScenario {
+		STRESS_OFF,
+		STRESS_FM_NYQUIST,   // FM depth 2.0 with all voices near Nyquist
+		STRESS_HARD_SYNC,    // Both sync switches forced to Hard
+		STRESS_PWM_SWEEP,    // PWM CV sweeping through the thresholds
+		STRESS_ALL,
+		STRESS_LEN
+	};
+	int stressScenario = STRESS_OFF;
+	int activeStressScenario = STRESS_OFF;
+	bool stressHardSync = false;
+	float stressPhase = 0.f;
+
+	// Input capture and replay (context menu > Diagnostics)
+	// Recording and replay both start from a reset DSP state, so a replayed
+	// capture reproduces the recorded outputs bit for bit (checked per frame
+	// against the recorded output hash). The outputs fade out before the reset
+	// and back in after it, so starting either does not click.
+	CvRecorder recorder;
+	CvReplay replay;
+	enum ReplayState {
+		REPLAY_IDLE,
+		REPLAY_START,    // UI loaded a capture, audio thread starts on the next frame
+		REPLAY_RUNNING,
+		REPLAY_STOP,     // UI requested an early stop
+		REPLAY_DONE,     // Results are valid; UI may load again
+	};
+	std::atomic<int> replayState{REPLAY_IDLE};
+	std::atomic<uint32_t> replaySeq{0};
+	float replaySavedParams[PARAMS_LEN];
+	int replaySavedBlockSize = 0;
+	bool replaySavedInternalRate = false;
+	int replaySavedMinBlepQuality = MINBLEP_DEFAULT_QUALITY;
+	static constexpr float CAPTURE_FADE_TIME = 0.005f;
+	float captureGain = 1.f;
+	bool captureResetPending = false;  // Fading out towards a reset this frame
 
 	HydraQuartetVCO() {
 		config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
@@ -376,6 +546,14 @@ struct HydraQuartetVCO : Module {
 		configSwitch(SYNC2_PARAM, 0.f, 2.f, 1.f, "VCO2 Sync", {"Hard", "Off", "Soft"});  // Center = Off
 		configParam(VIBRATO2_PARAM, 0.f, 1.f, 0.f, "VCO2 Vibrato", "%", 0.f, 100.f);
 
+		// Vibrato LFO bank (context menu sliders, not on the panel)
+		configParam(VIBRATO_RATE_PARAM, 0.5f, 12.f, 5.5f, "Vibrato rate", " Hz");
+		configParam(VIBRATO_DELAY_PARAM, 0.f, 3.f, 0.f, "Vibrato delay", " s");
+		configParam(VIBRATO_SPREAD_PARAM, 0.f, 1.f, 0.f, "Vibrato spread", "%", 0.f, 100.f);
+		paramQuantities[VIBRATO_RATE_PARAM]->randomizeEnabled = false;
+		paramQuantities[VIBRATO_DELAY_PARAM]->randomizeEnabled = false;
+		paramQuantities[VIBRATO_SPREAD_PARAM]->randomizeEnabled = false;
+
 		// Inputs
 		configInput(VOCT_INPUT, "V/Oct");
 		configInput(GATE_INPUT, "Gate");
@@ -416,14 +594,648 @@ struct HydraQuartetVCO : Module {
 		configOutput(GATE7_OUTPUT, "Gate 7");
 		configOutput(GATE8_OUTPUT, "Gate 8");
 		configOutput(GATE_MIX_OUTPUT, "Gate Mix");
+
+		freqTables[0].build12Tet();
+
+		static_assert(PARAMS_LEN <= CV_CAPTURE_MAX_PARAMS && INPUTS_LEN <= CV_CAPTURE_MAX_INPUTS,
+		              "Capture format holds at most 64 params and 32 inputs");
+
+		batch = BatchEngine::acquire();
+	}
+
+	~HydraQuartetVCO() {
+		if (batchSlot >= 0)
+			batch->leave(batchSlot);
+		BatchEngine::release();
+	}
+
+	// Build and publish a tuning table (UI thread)
+	// scl/kbm: Scala file contents, empty for 12-TET / the default linear mapping
+	// Waits for the audio thread to stop reading the table it replaces.
+	bool loadTuning(const std::string& scl, const std::string& kbm, std::string& error) {
+		uint32_t epoch = tuningEpoch.load(std::memory_order_relaxed);
+		for (int wait = 0; tuningAck.load(std::memory_order_acquire) != epoch; wait++) {
+			if (wait >= 500) {
+				error = "The previous tuning is still being applied (is the engine running?)";
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return applyTuning(scl, kbm, error);
+	}
+
+	// Build the inactive table and publish it without waiting: only when no
+	// render can be reading it (engine locked, or the module not yet added)
+	bool applyTuning(const std::string& scl, const std::string& kbm, std::string& error) {
+		uint32_t epoch = tuningEpoch.load(std::memory_order_relaxed) + 1;
+		FrequencyTable& table = freqTables[epoch & 1];
+		std::string name;
+		if (scl.empty() && kbm.empty()) {
+			table.build12Tet();
+			name = "12-TET";
+		}
+		else {
+			ScalaScale scale;
+			if (scl.empty()) {
+				for (int i = 1; i <= 12; i++)
+					scale.ratios.push_back(std::pow(2.0, i / 12.0));
+				scale.description = "12-TET";
+			}
+			else if (!parseScalaScale(scl, scale, error)) {
+				return false;
+			}
+			ScalaMapping mapping;
+			if (!kbm.empty() && !parseScalaMapping(kbm, mapping, error))
+				return false;
+			if (!table.build(scale, mapping)) {
+				error = "Scale and keyboard mapping do not produce valid frequencies";
+				return false;
+			}
+			name = string::trim(scale.description);
+			if (name.empty())
+				name = string::f("%d-note scale", (int)scale.ratios.size());
+		}
+		tuningEpoch.store(epoch, std::memory_order_release);
+		tuningScl = scl;
+		tuningKbm = kbm;
+		tuningName = name;
+		return true;
+	}
+
+	json_t* dataToJson() override {
+		json_t* rootJ = json_object();
+		json_object_set_new(rootJ, "blockSize", json_integer(blockSize));
+		json_object_set_new(rootJ, "internalRate", json_boolean(internalRate));
+		json_object_set_new(rootJ, "batch", json_boolean(batchEnabled));
+		json_object_set_new(rootJ, "scope", json_boolean(scopeEnabled));
+		json_object_set_new(rootJ, "minBlepQuality", json_integer(minBlepQuality));
+		json_object_set_new(rootJ, "tuningScl", json_string(tuningScl.c_str()));
+		json_object_set_new(rootJ, "tuningKbm", json_string(tuningKbm.c_str()));
+		return rootJ;
+	}
+
+	void dataFromJson(json_t* rootJ) override {
+		json_t* blockSizeJ = json_object_get(rootJ, "blockSize");
+		if (blockSizeJ)
+			blockSize = clamp((int)json_integer_value(blockSizeJ), 0, MAX_BLOCK_SIZE);
+
+		json_t* internalRateJ = json_object_get(rootJ, "internalRate");
+		if (internalRateJ)
+			internalRate = json_boolean_value(internalRateJ);
+
+		json_t* batchJ = json_object_get(rootJ, "batch");
+		if (batchJ)
+			batchEnabled = json_boolean_value(batchJ);
+
+		json_t* scopeJ = json_object_get(rootJ, "scope");
+		if (scopeJ)
+			scopeEnabled = json_boolean_value(scopeJ);
+
+		json_t* minBlepQualityJ = json_object_get(rootJ, "minBlepQuality");
+		if (minBlepQualityJ)
+			minBlepQuality = clamp((int)json_integer_value(minBlepQualityJ), 0, MINBLEP_KERNEL_COUNT - 1);
+
+		json_t* tuningSclJ = json_object_get(rootJ, "tuningScl");
+		json_t* tuningKbmJ = json_object_get(rootJ, "tuningKbm");
+		if (tuningSclJ || tuningKbmJ) {
+			const char* sclC = tuningSclJ ? json_string_value(tuningSclJ) : nullptr;
+			const char* kbmC = tuningKbmJ ? json_string_value(tuningKbmJ) : nullptr;
+			std::string scl = sclC ? sclC : "";
+			std::string kbm = kbmC ? kbmC : "";
+			std::string error;
+			// Rack loads module data with the engine locked (or before the module
+			// is added), so the table can be rebuilt without the handshake
+			if (!applyTuning(scl, kbm, error))
+				WARN("HydraQuartetVCO: could not restore tuning: %s", error.c_str());
+		}
 	}
 
 	void process(const ProcessArgs& args) override {
+		// Stress scenarios stand in for cables, so they run outside the measured
+		// frame. A replayed capture owns the inputs, so they pause meanwhile.
+		int state = replayState.load(std::memory_order_acquire);
+		bool replayPending = (state != REPLAY_IDLE && state != REPLAY_DONE);
+		if (!replayPending && (profiler.enabled || activeStressScenario != STRESS_OFF))
+			applyStressScenario(args.sampleTime);
+
+		if (!profiler.enabled) {
+			profilerWasEnabled = false;
+			processFrame(args);
+			return;
+		}
+
+		// Start a fresh measurement whenever profiling is switched on
+		if (!profilerWasEnabled) {
+			profiler.reset();
+			profilerWasEnabled = true;
+		}
+		auto start = std::chrono::steady_clock::now();
+		processFrame(args);
+		auto end = std::chrono::steady_clock::now();
+		profiler.record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+
+		profiler.checkOutputs(outputs[AUDIO_OUTPUT].getVoltages(), outputs[AUDIO_OUTPUT].getChannels());
+		profiler.checkOutputs(outputs[SUB_OUTPUT].getVoltages(), outputs[SUB_OUTPUT].getChannels());
+		if (profiler.reportDue(args.sampleRate))
+			profiler.publish(countSubnormalState());
+	}
+
+	// Everything process() does for one frame, timed as a whole by the profiler:
+	// tuning and replay handling, recording, controls, render, outputs, telemetry
+	void processFrame(const ProcessArgs& args) {
+		acknowledgeTuning();
+		captureResetPending = false;
+		bool replaying = applyReplayFrame();
+		recordInputs();
+		render(args, replaying);
+		fadeCapturedOutputs(args.sampleTime);
+		checkCapturedOutputs(replaying);
+	}
+
+	// Bypassed modules still acknowledge tunings, and leave the batch so it
+	// stops rendering their voices (and reading their tuning table)
+	// Bypass also ends a recording, since there are no outputs to capture; this
+	// publishes the last chunk of one that was stopped from the menu meanwhile.
+	void processBypass(const ProcessArgs& args) override {
+		acknowledgeTuning();
+		leaveBatch();
+		if (recorder.recording.load(std::memory_order_acquire) || recorder.streaming()) {
+			recorder.stop();
+			recorder.endStream();
+		}
+		Module::processBypass(args);
+	}
+
+	// Audio thread, once per frame: every render that could read a table
+	// older than the epoch read last frame has finished by now
+	void acknowledgeTuning() {
+		tuningAck.store(renderTuningEpoch, std::memory_order_release);
+		renderTuningEpoch = tuningEpoch.load(std::memory_order_acquire);
+	}
+
+	// Set an input's channel count from inside the module, including 0 and
+	// unpatched inputs (Port::setChannels() ignores disconnected ports)
+	// Higher channels are cleared, as a cable would leave them
+	static void overrideInputChannels(Input& input, int channels) {
+		for (int c = channels; c < PORT_MAX_CHANNELS; c++)
+			input.voltages[c] = 0.f;
+		input.channels = channels;
+	}
+
+	// Write pathological modulation into the input ports (profiling only)
+	// Overridden inputs are released when the scenario ends; patched cables
+	// restore their own values on the next engine frame
+	void applyStressScenario(float sampleTime) {
+		int scenario = profiler.enabled ? stressScenario : (int)STRESS_OFF;
+		if (scenario != activeStressScenario) {
+			overrideInputChannels(inputs[VOCT_INPUT], 0);
+			overrideInputChannels(inputs[FM_INPUT], 0);
+			overrideInputChannels(inputs[PWM1_INPUT], 0);
+			overrideInputChannels(inputs[PWM2_INPUT], 0);
+			activeStressScenario = scenario;
+		}
+		stressHardSync = (scenario == STRESS_HARD_SYNC || scenario == STRESS_ALL);
+		if (scenario == STRESS_OFF)
+			return;
+
+		bool fmNyquist = (scenario == STRESS_FM_NYQUIST || scenario == STRESS_ALL);
+		bool pwmSweep = (scenario == STRESS_PWM_SWEEP || scenario == STRESS_ALL);
+
+		// 16 voices: spread across the top octave for FM, mid range otherwise
+		overrideInputChannels(inputs[VOCT_INPUT], 16);
+		for (int c = 0; c < 16; c++) {
+			float voct = fmNyquist ? (4.5f + c / 16.f) : (1.f + c * (3.f / 16.f));
+			inputs[VOCT_INPUT].setVoltage(voct, c);
+		}
+
+		// 20V FM CV saturates depth at 2.0 regardless of the knob
+		if (fmNyquist) {
+			overrideInputChannels(inputs[FM_INPUT], 1);
+			inputs[FM_INPUT].setVoltage(20.f);
+		}
+
+		// Triangle sweep (+/-5V, 37 Hz) with per-voice offsets so some lane
+		// crosses a PWM threshold on most samples
+		if (pwmSweep) {
+			stressPhase += 37.f * sampleTime;
+			stressPhase -= std::floor(stressPhase);
+			overrideInputChannels(inputs[PWM1_INPUT], 16);
+			overrideInputChannels(inputs[PWM2_INPUT], 16);
+			for (int c = 0; c < 16; c++) {
+				float p = stressPhase + c / 16.f;
+				p -= std::floor(p);
+				float tri = 4.f * std::abs(p - 0.5f) - 1.f;
+				inputs[PWM1_INPUT].setVoltage(5.f * tri, c);
+				inputs[PWM2_INPUT].setVoltage(-5.f * tri, c);
+			}
+		}
+	}
+
+	// Start a recording (UI thread)
+	// sampleRate: engine rate the module runs at, stored for replay
+	bool startRecording(const std::string& path, float sampleRate, std::string& error) {
+		if (replayState.load(std::memory_order_acquire) != REPLAY_IDLE
+		    && replayState.load(std::memory_order_acquire) != REPLAY_DONE) {
+			error = "Cannot record while a capture is replaying";
+			return false;
+		}
+		CvCaptureHeader header;
+		header.sampleRate = sampleRate;
+		header.blockSize = blockSize;
+		header.internalRate = internalRate;
+		header.minBlepQuality = minBlepQuality;
+		header.tuningHash = tuningHash();
+		header.numParams = PARAMS_LEN;
+		header.numInputs = INPUTS_LEN;
+		return recorder.start(path, header, error);
+	}
+
+	// Load a capture and start replaying it on the next frame (UI thread)
+	// sampleRate: engine rate the capture must match, 0 to accept any
+	// warning: set if the capture was made with a different tuning
+	bool startReplay(const std::string& path, float sampleRate, std::string& error, std::string& warning) {
+		int state = replayState.load(std::memory_order_acquire);
+		if (state != REPLAY_IDLE && state != REPLAY_DONE) {
+			error = "A capture is already replaying";
+			return false;
+		}
+		if (recorder.recording.load(std::memory_order_acquire)) {
+			error = "Cannot replay while recording";
+			return false;
+		}
+		if (!replay.load(path, error))
+			return false;
+		if (replay.header.numParams != PARAMS_LEN || replay.header.numInputs != INPUTS_LEN) {
+			error = "Capture was made with a different version of this module";
+			return false;
+		}
+		// Block sizes the menu offers: 0 (off) or a power of two from 8 to MAX_BLOCK_SIZE
+		int32_t captureBlockSize = replay.header.blockSize;
+		if (captureBlockSize != 0 && (captureBlockSize < 8 || captureBlockSize > MAX_BLOCK_SIZE
+		                              || (captureBlockSize & (captureBlockSize - 1)) != 0)) {
+			error = string::f("Capture has an invalid block size (%d)", (int)captureBlockSize);
+			return false;
+		}
+		if (!(replay.header.sampleRate > 0.f)) {
+			error = "Capture has an invalid sample rate";
+			return false;
+		}
+		if (sampleRate > 0.f && replay.header.sampleRate != sampleRate) {
+			error = string::f("Capture was recorded at %g Hz; set the engine sample rate to match", replay.header.sampleRate);
+			return false;
+		}
+		if (replay.header.tuningHash != tuningHash())
+			warning = "Capture was recorded with a different tuning, so the outputs will not match";
+		replayState.store(REPLAY_START, std::memory_order_release);
+		return true;
+	}
+
+	void stopReplay() {
+		int running = REPLAY_RUNNING;
+		replayState.compare_exchange_strong(running, REPLAY_STOP);
+	}
+
+	// Feed the next captured frame into params and inputs (audio thread)
+	// Returns true while a capture is replaying
+	bool applyReplayFrame() {
+		int state = replayState.load(std::memory_order_acquire);
+		if (state == REPLAY_IDLE || state == REPLAY_DONE)
+			return false;
+
+		if (state == REPLAY_START) {
+			// The module's own inputs drive it until the fade-out completes
+			if (captureGain > 0.f) {
+				captureResetPending = true;
+				return false;
+			}
+			for (int i = 0; i < PARAMS_LEN; i++)
+				replaySavedParams[i] = params[i].getValue();
+			replaySavedBlockSize = blockSize;
+			replaySavedInternalRate = internalRate;
+			replaySavedMinBlepQuality = minBlepQuality;
+			blockSize = replay.header.blockSize;
+			internalRate = replay.header.internalRate;
+			minBlepQuality = clamp((int)replay.header.minBlepQuality, 0, MINBLEP_KERNEL_COUNT - 1);
+			resetDspState();
+			replayState.store(REPLAY_RUNNING, std::memory_order_release);
+		}
+		else if (state == REPLAY_STOP) {
+			finishReplay();
+			return false;
+		}
+
+		if (!replay.nextFrame()) {
+			finishReplay();
+			return false;
+		}
+		for (int i = 0; i < PARAMS_LEN; i++)
+			params[i].setValue(replay.params[i]);
+		for (int i = 0; i < INPUTS_LEN; i++) {
+			overrideInputChannels(inputs[i], replay.channels[i]);
+			for (int c = 0; c < replay.channels[i]; c++)
+				inputs[i].setVoltage(replay.voltages[i][c], c);
+		}
+		stressHardSync = replay.hardSync;
+		return true;
+	}
+
+	void finishReplay() {
+		for (int i = 0; i < PARAMS_LEN; i++)
+			params[i].setValue(replaySavedParams[i]);
+		blockSize = replaySavedBlockSize;
+		internalRate = replaySavedInternalRate;
+		minBlepQuality = replaySavedMinBlepQuality;
+		// A running stress scenario sets this again on the next frame
+		stressHardSync = false;
+		// Patched cables restore their own values on the next engine frame
+		for (int i = 0; i < INPUTS_LEN; i++)
+			overrideInputChannels(inputs[i], 0);
+		replaySeq.fetch_add(1, std::memory_order_release);
+		replayState.store(REPLAY_DONE, std::memory_order_release);
+	}
+
+	// Append this frame's params and inputs to the recording (audio thread)
+	void recordInputs() {
+		if (recorder.recording.load(std::memory_order_acquire)) {
+			// Replay starts from a reset state, so the recording does too
+			if (!recorder.streaming()) {
+				if (captureGain > 0.f) {
+					captureResetPending = true;
+					return;
+				}
+				resetDspState();
+			}
+			recorder.recordInputs(params, inputs, stressHardSync);
+		}
+		else if (recorder.streaming()) {
+			recorder.endStream();
+		}
+	}
+
+	// Fade the outputs out before the reset that starts a recording or replay,
+	// and back in after it. The fade-in starts at the reset in both, so it is
+	// part of the recorded outputs and replays to the same hashes.
+	void fadeCapturedOutputs(float sampleTime) {
+		float step = sampleTime / CAPTURE_FADE_TIME;
+		if (captureResetPending)
+			captureGain = std::max(captureGain - step, 0.f);
+		else if (captureGain < 1.f)
+			captureGain = std::min(captureGain + step, 1.f);
+		else
+			return;
+		// Every audio output; the gate outputs pass gates through unchanged
+		// (mono outputs may report 0 channels, as in hashOutputs())
+		for (int id = 0; id < GATE1_OUTPUT; id++) {
+			for (int c = 0; c < std::max(1, outputs[id].getChannels()); c++)
+				outputs[id].setVoltage(outputs[id].getVoltage(c) * captureGain, c);
+		}
+	}
+
+	void checkCapturedOutputs(bool replaying) {
+		if (recorder.streaming())
+			recorder.recordOutputHash(hashOutputs());
+		if (replaying)
+			replay.checkOutputHash(hashOutputs());
+	}
+
+	uint32_t hashOutputs() {
+		uint32_t hash = 2166136261u;
+		for (int id = 0; id < OUTPUTS_LEN; id++) {
+			uint8_t channels = outputs[id].getChannels();
+			hash = fnv1a(&channels, 1, hash);
+			hash = fnv1a(outputs[id].getVoltages(), std::max(1, (int)channels) * sizeof(float), hash);
+		}
+		return hash;
+	}
+
+	uint32_t tuningHash() {
+		uint32_t hash = fnv1a(tuningScl.data(), tuningScl.size());
+		return fnv1a(tuningKbm.data(), tuningKbm.size(), hash ^ 0xff);
+	}
+
+	// Return all oscillator, filter and buffer state to power-on values
+	void resetDspState() {
+		voices.reset();
+		activeVoices = 0;
+		upsampler.reset();
+		upsampledGroups = 0;
+		activeBlockSize = 0;
+		fifoPos = 0;
+	}
+
+	// Subnormal values anywhere in the DSP state (latency profiler report)
+	int countSubnormalState() {
+		return voices.countSubnormals();
+	}
+
+	// Block-rendering mode: render blockSize samples at once into a FIFO
+	// Controls are read at the block boundary, so CV changes land up to
+	// blockSize samples late. The audio itself is not delayed: fifo[0] is
+	// output in the call that renders the block (menu shows the hold time).
+	static constexpr int MAX_BLOCK_SIZE = 64;
+	int blockSize = 0;  // 0 = off (render per sample), else 8-64
+	int activeBlockSize = 0;
+	int blockChannels = 1;
+	int fifoPos = 0;
+	OutputFrame fifo[MAX_BLOCK_SIZE];
+	OutputFrame internalFrames[MAX_BLOCK_SIZE];  // Internal-rate frames before upsampling
+
+	// Fixed internal render rate: at 88.2 kHz and above, the oscillator core
+	// runs at the engine rate divided by a power of two (44.1-96 kHz) and is
+	// upsampled to the engine rate. MinBLEP edges stay exact at the internal rate.
+	static constexpr int MAX_RENDER_FACTOR = 8;
+	static constexpr float MIN_INTERNAL_RATE = 44100.f;
+	static constexpr int UPSAMPLER_TAPS = 16;
+	bool internalRate = false;
+	int renderFactor = 1;
+	// Index into MINBLEP_KERNELS: shorter kernels cost less per edge
+	int minBlepQuality = MINBLEP_DEFAULT_QUALITY;
+	int upsampledGroups = 0;
+	// Streams 0-3 = audio groups, 4-7 = sub groups
+	PolyphaseUpsampler<MAX_RENDER_FACTOR, UPSAMPLER_TAPS, 8> upsampler;
+
+	static int internalRateFactor(float sampleRate) {
+		int factor = 1;
+		while (factor < MAX_RENDER_FACTOR && sampleRate / (2 * factor) >= MIN_INTERNAL_RATE * 0.99f)
+			factor *= 2;
+		return factor;
+	}
+
+	// Cross-instance batched rendering (see BatchEngine)
+	// Only per-sample rendering at the engine rate is batched; block rendering,
+	// the internal render rate, recording and replay use the module's own voices.
+	// Only a last group of 1 or 2 voices goes to the batch: a group renders in
+	// about the same time however many of its voices are used, and with 3 the
+	// batch's per-voice copies cost more than packing saves (see
+	// tests/bench_batch.cpp). The other voices render in the module's own bank
+	// and are output one frame late, in step with the batched ones.
+	static constexpr int MAX_BATCH_VOICES = 2;
+	BatchEngine* batch = nullptr;
+	bool batchEnabled = false;
+	bool batchOverflow = false;  // Batch was full; retried once it has room
+	int batchSlot = -1;
+	int batchVoicesQueued = 0;  // Voices handed to the batch last frame
+	OutputFrame batchOwnFrame = {};  // Own voices rendered last frame
+	int batchOwnVoices = 0;
+	int activeVoices = 0;  // Voices rendered by the module's own bank last frame
+
+	void render(const ProcessArgs& args, bool replaying) {
+		FrameControls ctl;
+		OutputFrame frame;
+
+		int factor = internalRate ? internalRateFactor(args.sampleRate) : 1;
+		if (factor != renderFactor) {
+			renderFactor = factor;
+			upsampler.setFactor(factor);
+			upsampledGroups = 0;
+			activeBlockSize = 0;
+			fifoPos = 0;
+		}
+
+		if (blockSize <= 0 && renderFactor == 1) {
+			activeBlockSize = 0;
+			fifoPos = 0;
+			readControls(ctl);
+			if (batchEnabled && !replaying && !recorder.streaming()) {
+				if (batchOverflow && batch->hasRoom(ctl.channels % 4))
+					batchOverflow = false;
+				if (!batchOverflow && renderBatched(args, ctl))
+					return;
+			}
+			else {
+				leaveBatch();
+			}
+			activateVoices(ctl.channels);
+			voices.render(ctl, args.sampleTime, args.sampleRate, frame);
+			captureTelemetry(ctl.channels, ctl.fmDepth, frame, args.sampleTime);
+			writeOutputs(ctl.channels, frame);
+			processGatesAndLights(ctl.channels);
+			return;
+		}
+		leaveBatch();
+
+		// Refill the FIFO in one tight loop once the previous block is consumed
+		// (block sizes are powers of two, so they are multiples of renderFactor)
+		if (fifoPos >= activeBlockSize) {
+			activeBlockSize = clamp(std::max(blockSize, renderFactor), 1, MAX_BLOCK_SIZE);
+			readControls(ctl);
+			activateVoices(ctl.channels);
+			blockChannels = ctl.channels;
+			if (renderFactor == 1) {
+				voices.renderBlock(ctl, args.sampleTime, args.sampleRate, fifo, activeBlockSize);
+				for (int i = 0; i < activeBlockSize; i++)
+					captureTelemetry(ctl.channels, ctl.fmDepth, fifo[i], args.sampleTime);
+			}
+			else {
+				int frames = activeBlockSize / renderFactor;
+				voices.renderBlock(ctl, args.sampleTime * renderFactor, args.sampleRate / renderFactor, internalFrames, frames);
+				for (int i = 0; i < frames; i++) {
+					captureTelemetry(ctl.channels, ctl.fmDepth, internalFrames[i], args.sampleTime * renderFactor);
+					upsampleFrame(ctl.channels, internalFrames[i], &fifo[i * renderFactor]);
+				}
+			}
+			fifoPos = 0;
+		}
+		writeOutputs(blockChannels, fifo[fifoPos++]);
+		processGatesAndLights(blockChannels);
+	}
+
+	// Hand this frame's last group to the batch if it has 1 or 2 voices, render
+	// the others, and output the voices both rendered from the previous
+	// frame's controls. False if the batch has no room for this module, which
+	// then renders on its own.
+	bool renderBatched(const ProcessArgs& args, FrameControls& ctl) {
+		int batchVoices = ctl.channels % 4;
+		if (batchVoices > MAX_BATCH_VOICES)
+			batchVoices = 0;
+		int ownVoices = ctl.channels - batchVoices;
+		OutputFrame frame = batchOwnFrame;
+		int channels = 0;
+		// Nothing to exchange while the batch has none of the module's voices
+		if (batchVoices > 0 || batchVoicesQueued > 0) {
+			if (batchSlot < 0)
+				batchSlot = batch->join();
+			if (batchSlot < 0 || !batch->exchange(batchSlot, args.frame, args.sampleTime, args.sampleRate, ctl, ownVoices, frame, channels)) {
+				batchOverflow = true;
+				leaveBatch();
+				return false;
+			}
+			batchVoicesQueued = batchVoices;
+		}
+		channels += batchOwnVoices;
+
+		int totalChannels = ctl.channels;
+		ctl.channels = ownVoices;
+		activateVoices(ownVoices);
+		if (ownVoices > 0)
+			voices.render(ctl, args.sampleTime, args.sampleRate, batchOwnFrame);
+		batchOwnVoices = ownVoices;
+		ctl.channels = totalChannels;
+
+		// Nothing rendered yet on the frame the module joins: one silent sample
+		if (channels == 0) {
+			channels = ctl.channels;
+			std::memset(&frame, 0, sizeof(frame));
+		}
+		captureTelemetry(channels, ctl.fmDepth, frame, args.sampleTime);
+		writeOutputs(channels, frame);
+		processGatesAndLights(ctl.channels);
+		return true;
+	}
+
+	// Voices start from power-on state whenever the channel count brings them
+	// in, as they do in the batch, which allocates them afresh
+	void activateVoices(int channels) {
+		for (int lane = activeVoices; lane < channels; lane++)
+			voices.resetLane(lane, lane);
+		activeVoices = channels;
+	}
+
+	// Back to rendering every voice in the module's own bank, without delay
+	// The voices the batch rendered start afresh there (activateVoices)
+	void leaveBatch() {
+		if (batchSlot >= 0)
+			batch->leave(batchSlot);
+		batchSlot = -1;
+		batchVoicesQueued = 0;
+		batchOwnVoices = 0;
+	}
+
+	// Feed one rendered frame to the panel displays
+	void captureTelemetry(int channels, const float_4* fmDepth, const OutputFrame& frame, float sampleTime) {
+		if (!scopeEnabled)
+			return;
+		for (int g = 0; g < (channels + 3) / 4; g++)
+			telemetry.countEvents(g, frame.wrap1[g], frame.wrap2[g], frame.sync[g]);
+		telemetry.process(channels, frame.audio, fmDepth, frame.wrap1[0] & 1, sampleTime);
+	}
+
+	// Expand one internal-rate frame into renderFactor engine-rate frames
+	void upsampleFrame(int channels, const OutputFrame& frame, OutputFrame* out) {
+		int groups = (channels + 3) / 4;
+		// Groups that were silent have stale history from their last use
+		for (int g = upsampledGroups; g < groups; g++) {
+			upsampler.resetStream(g);
+			upsampler.resetStream(4 + g);
+		}
+		upsampledGroups = groups;
+
+		for (int g = 0; g < groups; g++) {
+			upsampler.push(g, frame.audio[g]);
+			upsampler.push(4 + g, frame.sub[g]);
+			for (int p = 0; p < renderFactor; p++) {
+				out[p].audio[g] = upsampler.process(g, p);
+				out[p].sub[g] = upsampler.process(4 + g, p);
+			}
+		}
+		upsampler.advance();
+	}
+
+	void readControls(FrameControls& ctl) {
 		// Get channel count from V/Oct input (bounded to valid range 1-16)
 		int channels = clamp(inputs[VOCT_INPUT].getChannels(), 1, 16);
-
-		float sampleTime = args.sampleTime;
-		float sampleRate = args.sampleRate;
+		ctl.channels = channels;
+		std::fill(ctl.minBlep, ctl.minBlep + 16, &MINBLEP_KERNELS[minBlepQuality]);
 
 		// Read pitch control parameters (outside loop - same for all voices)
 		float octave1 = std::round(params[OCTAVE1_PARAM].getValue());  // -2 to +2
@@ -458,34 +1270,32 @@ struct HydraQuartetVCO : Module {
 		}
 		float fineTuneVolts = fineTuneSemitones / 12.f;  // Convert semitones to V/Oct
 
+		// VCO1: octave + detune (VCO1 gets detune for thickness)
+		// VCO2: octave + fine tune
+		// Sub: -1 octave below VCO1 base
+		const FrequencyTable* freqTable = &freqTables[renderTuningEpoch & 1];
+		float pitchOffset1 = FrequencyTable::indexOffset(octave1 + detuneVolts);
+		float pitchOffset2 = FrequencyTable::indexOffset(octave2 + fineTuneVolts);
+		float subPitchOffset = FrequencyTable::indexOffset(octave1 - 1.f);
+
 		// Read sub-oscillator parameters
 		float subWave = params[SUB_WAVE_PARAM].getValue();  // 0 = square, 1 = sine
 
-		// Fixed output scaling - divide by 3 (typical number of active waveforms)
-		// User controls final level via individual waveform volumes
-		const float outputScale = 1.f / 3.f;
-
 		// Read sync switch states (0=Hard, 1=Off, 2=Soft)
 		int sync1Mode = (int)std::round(params[SYNC1_PARAM].getValue());  // VCO1 syncs to VCO2
 		int sync2Mode = (int)std::round(params[SYNC2_PARAM].getValue());  // VCO2 syncs to VCO1
-		bool sync1Hard = (sync1Mode == 0);
-		bool sync1Soft = (sync1Mode == 2);
-		bool sync2Hard = (sync2Mode == 0);
-		bool sync2Soft = (sync2Mode == 2);
+		bool sync1Hard = (sync1Mode == 0) || stressHardSync;
+		bool sync1Soft = (sync1Mode == 2) && !stressHardSync;
+		bool sync2Hard = (sync2Mode == 0) || stressHardSync;
+		bool sync2Soft = (sync2Mode == 2) && !stressHardSync;
 
 		// Read vibrato parameters (0-1 range)
 		float vibrato1Depth = params[VIBRATO1_PARAM].getValue();
 		float vibrato2Depth = params[VIBRATO2_PARAM].getValue();
-
-		// Update vibrato LFO (5.5 Hz sine, typical vibrato rate)
-		const float vibratoRate = 5.5f;
-		vibratoPhase += vibratoRate * sampleTime;
-		if (vibratoPhase >= 1.f) vibratoPhase -= 1.f;
-		float vibratoLfo = std::sin(vibratoPhase * 2.f * M_PI);
-
-		// Vibrato modulation in V/Oct (max +/- 0.5 semitone = +/- 1/24 volt)
-		float vibratoMod1 = vibratoLfo * vibrato1Depth * (0.5f / 12.f);
-		float vibratoMod2 = vibratoLfo * vibrato2Depth * (0.5f / 12.f);
+		float vibratoRate = params[VIBRATO_RATE_PARAM].getValue();
+		float vibratoDelay = params[VIBRATO_DELAY_PARAM].getValue();
+		float vibratoSpread = params[VIBRATO_SPREAD_PARAM].getValue();
+		bool gateConnected = inputs[GATE_INPUT].isConnected();
 
 		// Read waveform volume knobs (for CV-replaces-knob pattern)
 		float saw1Knob = params[SAW1_PARAM].getValue();
@@ -503,34 +1313,46 @@ struct HydraQuartetVCO : Module {
 		bool sqr2CVConnected = inputs[SQR2_CV_INPUT].isConnected();
 		bool saw2CVConnected = inputs[SAW2_CV_INPUT].isConnected();
 
-		// Process in SIMD groups of 4 voices
+		int fmChannels = inputs[FM_INPUT].getChannels();
+
 		for (int c = 0; c < channels; c += 4) {
-			int groupChannels = std::min(channels - c, 4);
 			int g = c / 4;  // SIMD group index
 
-			// Load 4 channels of V/Oct using SIMD
-			float_4 basePitch = inputs[VOCT_INPUT].getPolyVoltageSimd<float_4>(c);
-
-			// VCO1: base + octave + detune + vibrato (VCO1 gets detune for thickness)
-			float_4 pitch1 = basePitch + octave1 + detuneVolts + vibratoMod1;
-			float_4 freq1 = dsp::FREQ_C4 * dsp::exp2_taylor5(pitch1);
-			freq1 = simd::clamp(freq1, 0.1f, sampleRate / 2.f);
+			// Knob and switch settings apply to every voice
+			for (int i = 0; i < 4; i++)
+				ctl.freqTable[c + i] = freqTable;
+			ctl.pitchOffset1[g] = pitchOffset1;
+			ctl.pitchOffset2[g] = pitchOffset2;
+			ctl.subPitchOffset[g] = subPitchOffset;
+			ctl.triVol1[g] = triVol1;
+			ctl.sinVol1[g] = sinVol1;
+			ctl.triVol2[g] = triVol2;
+			ctl.sinVol2[g] = sinVol2;
+			ctl.subWave[g] = subWave;
+			ctl.fmSource[g] = fmSource;
+			ctl.fmSourceLanes[g] = (float)fmSource;
+			ctl.sync1Hard[g] = sync1Hard ? 0xf : 0;
+			ctl.sync1Soft[g] = sync1Soft ? 0xf : 0;
+			ctl.sync2Hard[g] = sync2Hard ? 0xf : 0;
+			ctl.sync2Soft[g] = sync2Soft ? 0xf : 0;
+			ctl.vibrato1Depth[g] = vibrato1Depth;
+			ctl.vibrato2Depth[g] = vibrato2Depth;
+			ctl.vibratoRate[g] = vibratoRate;
+			ctl.vibratoDelay[g] = vibratoDelay;
+			ctl.vibratoSpread[g] = vibratoSpread;
+			ctl.gateConnected[g] = gateConnected ? 1.f : 0.f;
 
-			// VCO2: base + octave + fine tune + vibrato
-			float_4 pitch2 = basePitch + octave2 + fineTuneVolts + vibratoMod2;
-			float_4 freq2Base = dsp::FREQ_C4 * dsp::exp2_taylor5(pitch2);
+			// Load 4 channels of V/Oct using SIMD
+			ctl.basePitch[g] = inputs[VOCT_INPUT].getPolyVoltageSimd<float_4>(c);
 
 			// Read polyphonic PWM CV
 			float_4 pwm1CV = inputs[PWM1_INPUT].getPolyVoltageSimd<float_4>(c);
 			float_4 pwm2CV = inputs[PWM2_INPUT].getPolyVoltageSimd<float_4>(c);
 
 			// Apply CV: +/-5V * 0.1 = +/-0.5 contribution (full sweep range)
-			float_4 pwm1_4 = pwm1 + pwm1CV * 0.1f;
-			float_4 pwm2_4 = pwm2 + pwm2CV * 0.1f;
-
 			// Clamp to safe PWM range (avoid DC at extremes)
-			pwm1_4 = simd::clamp(pwm1_4, 0.01f, 0.99f);
-			pwm2_4 = simd::clamp(pwm2_4, 0.01f, 0.99f);
+			ctl.pwm1[g] = simd::clamp(pwm1 + pwm1CV * 0.1f, 0.01f, 0.99f);
+			ctl.pwm2[g] = simd::clamp(pwm2 + pwm2CV * 0.1f, 0.01f, 0.99f);
 
 			// Read waveform volume CVs (polyphonic)
 			float_4 saw1CV = inputs[SAW1_CV_INPUT].getPolyVoltageSimd<float_4>(c);
@@ -541,178 +1363,59 @@ struct HydraQuartetVCO : Module {
 			float_4 saw2CV = inputs[SAW2_CV_INPUT].getPolyVoltageSimd<float_4>(c);
 
 			// CV replaces knob when patched, 0-10V maps to 0-10 volume
-			float_4 saw1Vol_4 = saw1CVConnected ? simd::clamp(saw1CV, 0.f, 10.f) : float_4(saw1Knob);
-			float_4 sqr1Vol_4 = sqr1CVConnected ? simd::clamp(sqr1CV, 0.f, 10.f) : float_4(sqr1Knob);
-			float_4 subVol_4 = subCVConnected ? simd::clamp(subCV, 0.f, 10.f) : float_4(subKnob);
-			float_4 xorVol_4 = xorCVConnected ? simd::clamp(xorCV, 0.f, 10.f) : float_4(xorKnob);
-			float_4 sqr2Vol_4 = sqr2CVConnected ? simd::clamp(sqr2CV, 0.f, 10.f) : float_4(sqr2Knob);
-			float_4 saw2Vol_4 = saw2CVConnected ? simd::clamp(saw2CV, 0.f, 10.f) : float_4(saw2Knob);
-
-			// Phase 1: Process VCO1 first to get waveforms for FM source
-			float_4 saw1, sqr1, tri1, sine1;
-			int vco1WrapMask;
-			vco1.process(g, freq1, sampleTime, pwm1_4, saw1, sqr1, tri1, sine1, vco1WrapMask);
-
-			// Sub-oscillator: -1 octave below VCO1 base (need this early for FM source)
-			float_4 subPitch = basePitch + octave1 - 1.f;
-			float_4 subFreq = dsp::FREQ_C4 * dsp::exp2_taylor5(subPitch);
-			subFreq = simd::clamp(subFreq, 1.f, 20000.f);
-			subPhase[g] += subFreq * sampleTime;
-			subPhase[g] -= simd::floor(subPhase[g]);
-			float_4 subSquare = simd::ifelse(subPhase[g] < 0.5f, 1.f, -1.f);
-			float_4 subSine = simd::sin(2.f * float(M_PI) * subPhase[g]);
-			float_4 subOut = (subWave < 0.5f) ? subSquare : subSine;
-
-			// Select FM source waveform (0=Sin, 1=Tri, 2=Saw, 3=Sqr, 4=Sub)
-			float_4 fmModulator;
-			switch (fmSource) {
-				case 0: fmModulator = sine1; break;
-				case 1: fmModulator = tri1; break;
-				case 2: fmModulator = saw1; break;
-				case 3: fmModulator = sqr1; break;
-				case 4: fmModulator = subOut; break;
-				default: fmModulator = sine1; break;
-			}
-
-			// Through-zero linear FM: selected VCO1 waveform modulates VCO2 frequency
+			ctl.saw1Vol[g] = saw1CVConnected ? simd::clamp(saw1CV, 0.f, 10.f) : float_4(saw1Knob);
+			ctl.sqr1Vol[g] = sqr1CVConnected ? simd::clamp(sqr1CV, 0.f, 10.f) : float_4(sqr1Knob);
+			ctl.subVol[g] = subCVConnected ? simd::clamp(subCV, 0.f, 10.f) : float_4(subKnob);
+			ctl.xorVol[g] = xorCVConnected ? simd::clamp(xorCV, 0.f, 10.f) : float_4(xorKnob);
+			ctl.sqr2Vol[g] = sqr2CVConnected ? simd::clamp(sqr2CV, 0.f, 10.f) : float_4(sqr2Knob);
+			ctl.saw2Vol[g] = saw2CVConnected ? simd::clamp(saw2CV, 0.f, 10.f) : float_4(saw2Knob);
+
+			// Through-zero linear FM depth: knob + (CV * scale)
 			// Read FM CV (auto-detect poly/mono)
 			float_4 fmCV;
-			int fmChannels = inputs[FM_INPUT].getChannels();
 			if (fmChannels > 1) {
 				fmCV = inputs[FM_INPUT].getPolyVoltageSimd<float_4>(c);
 			} else {
 				fmCV = float_4(inputs[FM_INPUT].getVoltage());
 			}
+			ctl.fmDepth[g] = simd::clamp(fmKnob + fmCV * 0.1f, 0.f, 2.f);
 
-			// Calculate per-voice FM depth: knob + (CV * scale)
-			float_4 fmDepth = fmKnob + fmCV * 0.1f;
-			fmDepth = simd::clamp(fmDepth, 0.f, 2.f);
-
-			// Apply linear FM using selected waveform as modulator
-			// fmModulator is ±1, so freq2 = freq2Base * (1 + fmModulator * fmDepth)
-			float_4 freq2 = freq2Base + freq2Base * fmModulator * fmDepth;
-			freq2 = simd::clamp(freq2, 0.1f, sampleRate / 2.f);
-
-			// Phase 2: Process VCO2 with FM-modulated frequency
-			float_4 saw2, sqr2, tri2, sine2, xorOut;
-			int vco2WrapMask;
-			vco2.process(g, freq2, sampleTime, pwm2_4, saw2, sqr2, tri2, sine2, vco2WrapMask, sqr1, &xorOut);
-
-			// Track VCO1 square edges for XOR MinBLEP (XOR = sqr1 * sqr2)
-			// When sqr1 transitions, XOR changes by 2 * sqr2
-
-			// VCO1 rising edge (wrap)
-			if (vco1WrapMask) {
-				for (int i = 0; i < 4; i++) {
-					if ((vco1WrapMask & (1 << i)) && vco1.deltaPhase[g][i] > 0.f) {
-						float subsample = (1.f - vco1.oldPhase[g][i]) / vco1.deltaPhase[g][i] - 1.f;
-						// sqr1: -1 -> +1, so XOR changes by 2 * sqr2
-						float xorDisc = 2.f * sqr2[i];
-						xorFromVco1MinBlep[g].insertDiscontinuity(subsample, xorDisc, i);
-					}
-				}
-			}
-
-			// VCO1 falling edge (PWM threshold)
-			float_4 vco1FallingEdge = (vco1.oldPhase[g] < pwm1_4) & (vco1.phase[g] >= pwm1_4);
-			int vco1FallMask = simd::movemask(vco1FallingEdge);
-			if (vco1FallMask) {
-				for (int i = 0; i < 4; i++) {
-					if ((vco1FallMask & (1 << i)) && vco1.deltaPhase[g][i] > 0.f) {
-						float subsample = (pwm1_4[i] - vco1.oldPhase[g][i]) / vco1.deltaPhase[g][i] - 1.f;
-						// sqr1: +1 -> -1, so XOR changes by -2 * sqr2
-						float xorDisc = -2.f * sqr2[i];
-						xorFromVco1MinBlep[g].insertDiscontinuity(subsample, xorDisc, i);
-					}
-				}
-			}
-
-			// Combine MinBLEP corrections from both VCO1 and VCO2 edges
-			xorOut += xorFromVco1MinBlep[g].process();
-
-			// Phase 2: Apply sync resets AFTER both VCOs have processed (order matters for bidirectional)
-			// Hard sync: oscillator resets at the start of the other oscillator's cycle
-			// Soft sync: sync amount based on master waveform magnitude
-			if (sync1Hard && vco2WrapMask) {
-				// VCO1 hard syncs to VCO2: when VCO2 wraps, reset VCO1
-				vco1.applySync(g, vco2WrapMask, vco2.oldPhase[g], vco2.deltaPhase[g], pwm1_4,
-				               saw1, sqr1, tri1);
-			}
-			if (sync1Soft && vco2WrapMask) {
-				// VCO1 soft syncs to VCO2: sync amount proportional to VCO2 waveform magnitude
-				for (int i = 0; i < 4; i++) {
-					if (vco2WrapMask & (1 << i)) {
-						// Use sine2 magnitude to determine sync strength (0-1)
-						float magnitude = std::abs(sine2[i]);
-						// Blend between current phase and reset phase based on magnitude
-						vco1.phase[g][i] = vco1.phase[g][i] * (1.f - magnitude);
-					}
-				}
-			}
-			if (sync2Hard && vco1WrapMask) {
-				// VCO2 hard syncs to VCO1: when VCO1 wraps, reset VCO2
-				vco2.applySync(g, vco1WrapMask, vco1.oldPhase[g], vco1.deltaPhase[g], pwm2_4,
-				               saw2, sqr2, tri2);
-			}
-			if (sync2Soft && vco1WrapMask) {
-				// VCO2 soft syncs to VCO1: sync amount proportional to VCO1 waveform magnitude
-				for (int i = 0; i < 4; i++) {
-					if (vco1WrapMask & (1 << i)) {
-						// Use sine1 magnitude to determine sync strength (0-1)
-						float magnitude = std::abs(sine1[i]);
-						// Blend between current phase and reset phase based on magnitude
-						vco2.phase[g][i] = vco2.phase[g][i] * (1.f - magnitude);
-					}
-				}
-			}
+			// Gates retrigger the vibrato delay (mono gate applies to all voices)
+			ctl.gate[g] = inputs[GATE_INPUT].getPolyVoltageSimd<float_4>(c);
+		}
+	}
 
-			// Output sub to dedicated SUB jack (reduced to ±2V for testing)
-			// Sanitize: subOut is mathematically bounded but defend against upstream NaN
-			float_4 subVoltage = subOut * 2.f;
-			for (int i = 0; i < 4; i++) {
-				if (!std::isfinite(subVoltage[i])) subVoltage[i] = 0.f;
-			}
-			outputs[SUB_OUTPUT].setVoltageSimd(subVoltage, c);
-
-			// Mix both VCOs with CV-controlled volumes, plus sub-oscillator and XOR
-			// Note: tri and sine still use scalar knob values (no CV per Context decision)
-			float_4 mixed = (tri1 * triVol1 + sqr1 * sqr1Vol_4 + sine1 * sinVol1 + saw1 * saw1Vol_4
-			              + tri2 * triVol2 + sqr2 * sqr2Vol_4 + sine2 * sinVol2 + saw2 * saw2Vol_4
-			              + subOut * subVol_4
-			              + xorOut * xorVol_4
-			              ) * outputScale;
-
-			// DC filtering and soft clipping - process per-voice
-			for (int i = 0; i < groupChannels; i++) {
-				dcFilters[c + i].setCutoffFreq(10.f / sampleRate);
-				dcFilters[c + i].process(mixed[i]);
-				float dcFiltered = dcFilters[c + i].highpass();
-
-				// Soft clipping with tanh
-				// Scale factor 3.0: saturates at approximately +/-3V input
-				// This prevents harsh digital clipping when many waveforms sum
-				float softClipped = 3.f * std::tanh(dcFiltered / 3.f);
-
-				// Apply output scaling (+/-2V for testing, +/-5V for production)
-				float out = softClipped * 2.f;
-
-				// Sanitize output: replace NaN/Inf with 0 to prevent propagation
-				mixed[i] = std::isfinite(out) ? out : 0.f;
-
-				// Per-voice outputs (only for voices 1-8)
-				int voiceIdx = c + i;
-				if (voiceIdx < 8) {
-					outputs[VOICE1_OUTPUT + voiceIdx].setVoltage(mixed[i]);
-				}
-			}
+	void writeOutputs(int channels, const OutputFrame& frame) {
+		for (int c = 0; c < channels; c += 4) {
+			int g = c / 4;
+			outputs[AUDIO_OUTPUT].setVoltageSimd(frame.audio[g], c);
+			outputs[SUB_OUTPUT].setVoltageSimd(frame.sub[g], c);
+		}
 
-			outputs[AUDIO_OUTPUT].setVoltageSimd(mixed, c);
+		// Per-voice outputs (only for voices 1-8)
+		int voiceOutputs = std::min(channels, 8);
+		for (int v = 0; v < voiceOutputs; v++) {
+			outputs[VOICE1_OUTPUT + v].setVoltage(frame.audio[v / 4][v % 4]);
 		}
 
 		// Set output channel count (CRITICAL for polyphonic operation)
 		outputs[AUDIO_OUTPUT].setChannels(channels);
 		outputs[SUB_OUTPUT].setChannels(channels);
 
+		// Mix output using horizontal sum for efficiency
+		float_4 mixSum = 0.f;
+		for (int g = 0; g < (channels + 3) / 4; g++) {
+			mixSum += outputs[AUDIO_OUTPUT].getVoltageSimd<float_4>(g * 4);
+		}
+		mixSum.v = _mm_hadd_ps(mixSum.v, mixSum.v);
+		mixSum.v = _mm_hadd_ps(mixSum.v, mixSum.v);
+		// Proportional mix: voices sum together (more voices = louder mix)
+		float mixOut = mixSum[0];
+		// Sanitize mix output
+		outputs[MIX_OUTPUT].setVoltage(std::isfinite(mixOut) ? mixOut : 0.f);
+	}
+
+	void processGatesAndLights(int channels) {
 		// Per-voice gate pass-through (voices 1-8)
 		int gateChannels = inputs[GATE_INPUT].getChannels();
 		float gateMix = 0.f;
@@ -727,18 +1430,6 @@ struct HydraQuartetVCO : Module {
 		}
 		outputs[GATE_MIX_OUTPUT].setVoltage(gateMix);
 
-		// Mix output using horizontal sum for efficiency
-		float_4 mixSum = 0.f;
-		for (int g = 0; g < (channels + 3) / 4; g++) {
-			mixSum += outputs[AUDIO_OUTPUT].getVoltageSimd<float_4>(g * 4);
-		}
-		mixSum.v = _mm_hadd_ps(mixSum.v, mixSum.v);
-		mixSum.v = _mm_hadd_ps(mixSum.v, mixSum.v);
-		// Proportional mix: voices sum together (more voices = louder mix)
-		float mixOut = mixSum[0];
-		// Sanitize mix output
-		outputs[MIX_OUTPUT].setVoltage(std::isfinite(mixOut) ? mixOut : 0.f);
-
 		// PWM CV activity indicators
 		if (inputs[PWM1_INPUT].isConnected()) {
 			float peakCV = 0.f;
@@ -775,7 +1466,144 @@ struct HydraQuartetVCO : Module {
 };
 
 
+// Latest telemetry as seen by the panel displays (UI thread only)
+struct TelemetryView {
+	int channels = 0;
+	float scope[16][TelemetryPacket::POINTS] = {};
+	float freq1[16] = {};     // Smoothed VCO1 cycles per second
+	float freq2[16] = {};     // Smoothed VCO2 cycles per second
+	float syncFlash[16] = {}; // 1 on a frame with sync resets, then decays
+	float fmDepth[16] = {};
+
+	void update(const TelemetryPacket& packet) {
+		channels = packet.channels;
+		std::memcpy(scope, packet.scope, sizeof(scope));
+		if (packet.duration <= 0.f)
+			return;
+		// A 40 ms frame only holds a few cycles of a bass note, so rates are smoothed
+		const float smoothing = 0.3f;
+		for (int c = 0; c < 16; c++) {
+			freq1[c] += (packet.edges1[c] / packet.duration - freq1[c]) * smoothing;
+			freq2[c] += (packet.edges2[c] / packet.duration - freq2[c]) * smoothing;
+			if (packet.syncs[c] > 0)
+				syncFlash[c] = 1.f;
+			fmDepth[c] = packet.fmDepth[c];
+		}
+	}
+
+	void decay(float dt) {
+		for (int c = 0; c < 16; c++)
+			syncFlash[c] = std::max(0.f, syncFlash[c] - dt * 4.f);
+	}
+};
+
+static NVGcolor voiceColor(int c) {
+	return nvgHSLA(c / 16.f, 0.8f, 0.6f, 0xff);
+}
+
+static void drawDisplayBackground(NVGcontext* vg, math::Vec size) {
+	nvgBeginPath(vg);
+	nvgRoundedRect(vg, 0.f, 0.f, size.x, size.y, 3.f);
+	nvgFillColor(vg, nvgRGB(0x14, 0x14, 0x18));
+	nvgFill(vg);
+}
+
+// Stacked per-voice traces, one row per active voice
+struct VoiceScopeDisplay : TransparentWidget {
+	const TelemetryView* view = nullptr;
+
+	void draw(const DrawArgs& args) override {
+		drawDisplayBackground(args.vg, box.size);
+	}
+
+	void drawLayer(const DrawArgs& args, int layer) override {
+		if (layer != 1 || !view || view->channels <= 0)
+			return;
+		float rowHeight = box.size.y / view->channels;
+		float dx = box.size.x / (TelemetryPacket::POINTS - 1);
+		nvgSave(args.vg);
+		nvgScissor(args.vg, 0.f, 0.f, box.size.x, box.size.y);
+		nvgStrokeWidth(args.vg, 1.f);
+		for (int c = 0; c < view->channels; c++) {
+			float center = (c + 0.5f) * rowHeight;
+			// Outputs are soft-clipped to +/-6V
+			float scale = -0.5f * rowHeight / 6.f;
+			nvgBeginPath(args.vg);
+			for (int i = 0; i < TelemetryPacket::POINTS; i++) {
+				float y = center + clamp(view->scope[c][i], -6.f, 6.f) * scale;
+				if (i == 0)
+					nvgMoveTo(args.vg, 0.f, y);
+				else
+					nvgLineTo(args.vg, i * dx, y);
+			}
+			nvgStrokeColor(args.vg, voiceColor(c));
+			nvgStroke(args.vg);
+		}
+		nvgRestore(args.vg);
+	}
+};
+
+// Per-voice activity rows, aligned with the scope: VCO1/VCO2 cycle rate on a
+// log scale (20 Hz - 20 kHz), FM depth, and a sync indicator
+struct VoiceActivityDisplay : TransparentWidget {
+	const TelemetryView* view = nullptr;
+
+	void draw(const DrawArgs& args) override {
+		drawDisplayBackground(args.vg, box.size);
+	}
+
+	void drawLayer(const DrawArgs& args, int layer) override {
+		if (layer != 1 || !view || view->channels <= 0)
+			return;
+		float rowHeight = box.size.y / view->channels;
+		float pad = std::min(1.f, rowHeight * 0.1f);
+		float barHeight = (rowHeight - 3.f * pad) / 2.f;
+		float rateWidth = box.size.x * 0.6f;
+		float fmX = box.size.x * 0.65f, fmWidth = box.size.x * 0.2f;
+		float syncX = box.size.x * 0.88f, syncWidth = box.size.x * 0.1f;
+
+		for (int c = 0; c < view->channels; c++) {
+			float top = c * rowHeight;
+			NVGcolor color = voiceColor(c);
+
+			const float rates[2] = {view->freq1[c], view->freq2[c]};
+			for (int v = 0; v < 2; v++) {
+				float x = clamp(std::log2(std::max(rates[v], 1.f) / 20.f) / std::log2(1000.f), 0.f, 1.f);
+				nvgBeginPath(args.vg);
+				nvgRect(args.vg, 0.f, top + pad + v * (barHeight + pad), x * rateWidth, barHeight);
+				nvgFillColor(args.vg, color);
+				nvgFill(args.vg);
+			}
+
+			// FM depth 0-2
+			nvgBeginPath(args.vg);
+			nvgRect(args.vg, fmX, top + pad, clamp(view->fmDepth[c] / 2.f, 0.f, 1.f) * fmWidth, rowHeight - 2.f * pad);
+			nvgFillColor(args.vg, nvgRGBA(0xff, 0xb0, 0x40, 0xc0));
+			nvgFill(args.vg);
+
+			if (view->syncFlash[c] > 0.f) {
+				nvgBeginPath(args.vg);
+				nvgRect(args.vg, syncX, top + pad, syncWidth, rowHeight - 2.f * pad);
+				nvgFillColor(args.vg, nvgRGBA(0xff, 0xff, 0xff, (unsigned char)(0xff * view->syncFlash[c])));
+				nvgFill(args.vg);
+			}
+		}
+	}
+};
+
+
+// Context menu slider for params that have no panel control
+struct MenuParamSlider : ui::Slider {
+	MenuParamSlider(Quantity* quantity) {
+		this->quantity = quantity;
+		box.size.x = 200.f;
+	}
+};
+
+
 struct HydraQuartetVCOWidget : ModuleWidget {
+	TelemetryView telemetryView;
+
 	HydraQuartetVCOWidget(HydraQuartetVCO* module) {
 		setModule(module);
 		setPanel(createPanel(asset::plugin(pluginInstance, "res/HydraQuartetVCO.svg")));
@@ -835,6 +1663,16 @@ struct HydraQuartetVCOWidget : ModuleWidget {
 		// Polyphonic audio output - above output plate section
 		addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(101.6, 85.0)), module, HydraQuartetVCO::AUDIO_OUTPUT));
 
+		// Voice scope and activity displays either side of the global column
+		VoiceScopeDisplay* scope = createWidget<VoiceScopeDisplay>(mm2px(Vec(73.5, 47.0)));
+		scope->box.size = mm2px(Vec(20.0, 48.0));
+		scope->view = module ? &telemetryView : nullptr;
+		addChild(scope);
+		VoiceActivityDisplay* activity = createWidget<VoiceActivityDisplay>(mm2px(Vec(109.7, 47.0)));
+		activity->box.size = mm2px(Vec(20.0, 48.0));
+		activity->view = module ? &telemetryView : nullptr;
+		addChild(activity);
+
 		// Lower left corner: PWM CV and Sub output
 		addInput(createInputCentered<PJ301MPort>(mm2px(Vec(10.0, 110.0)), module, HydraQuartetVCO::PWM1_INPUT));
 		// Sub output in VCO1 area
@@ -901,6 +1739,240 @@ struct HydraQuartetVCOWidget : ModuleWidget {
 		addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(165.0, 123.0)), module, HydraQuartetVCO::VOICE7_OUTPUT));
 		addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(178.0, 123.0)), module, HydraQuartetVCO::VOICE8_OUTPUT));
 	}
+
+	// Latest latency report, logged from the UI thread (never from process())
+	LatencyReport latencyReport;
+	bool hasLatencyReport = false;
+	uint32_t lastReplaySeq = 0;
+
+	void step() override {
+		HydraQuartetVCO* module = getModule<HydraQuartetVCO>();
+		if (module) {
+			SpscRing<LatencyReport, 4>& reports = module->profiler.reports;
+			while (const LatencyReport* report = reports.consumerSlot()) {
+				latencyReport = *report;
+				hasLatencyReport = true;
+				reports.consume();
+				const LatencyReport& r = latencyReport;
+				INFO("HydraQuartetVCO latency (%llu samples): mean %.0f ns, p50 %.0f ns, p99 %.0f ns, p99.9 %.0f ns, max %.0f ns; "
+				     "64-sample block p99 %.0f ns, max %.0f ns; subnormal outputs %llu, subnormal state %d",
+				     (unsigned long long)r.samples, r.meanNs, r.p50Ns, r.p99Ns, r.p999Ns, r.maxNs,
+				     r.blockP99Ns, r.blockMaxNs, (unsigned long long)r.subnormalOutputs, r.subnormalState);
+			}
+
+			uint32_t replaySeq = module->replaySeq.load(std::memory_order_acquire);
+			if (replaySeq != lastReplaySeq) {
+				lastReplaySeq = replaySeq;
+				const CvReplay& r = module->replay;
+				INFO("HydraQuartetVCO replay: %llu frames, %llu output mismatches (first at frame %lld)",
+				     (unsigned long long)r.frames, (unsigned long long)r.mismatches, (long long)r.firstMismatch);
+			}
+
+			// Drain the telemetry ring; only the newest frame is drawn
+			SpscRing<TelemetryPacket, 4>& ring = module->telemetry.ring;
+			while (const TelemetryPacket* packet = ring.consumerSlot()) {
+				telemetryView.update(*packet);
+				ring.consume();
+			}
+			if (!module->scopeEnabled)
+				telemetryView.channels = 0;
+			telemetryView.decay(APP->window->getLastFrameDuration());
+		}
+		ModuleWidget::step();
+	}
+
+	// Load a Scala scale or keyboard mapping from disk (UI thread)
+	static void loadTuningFile(HydraQuartetVCO* module, bool keyboardMapping) {
+		osdialog_filters* filters = osdialog_filters_parse(keyboardMapping
+			? "Scala keyboard mapping (.kbm):kbm"
+			: "Scala scale (.scl):scl");
+		DEFER({osdialog_filters_free(filters);});
+		char* pathC = osdialog_file(OSDIALOG_OPEN, NULL, NULL, filters);
+		if (!pathC)
+			return;
+		std::string path = pathC;
+		std::free(pathC);
+
+		std::ifstream file(path, std::ios::binary);
+		std::stringstream text;
+		text << file.rdbuf();
+
+		std::string scl = keyboardMapping ? module->tuningScl : text.str();
+		std::string kbm = keyboardMapping ? text.str() : module->tuningKbm;
+		std::string error;
+		if (!file || !module->loadTuning(scl, kbm, error)) {
+			std::string message = "Could not load " + string::filename(path) + (error.empty() ? "" : ": " + error);
+			osdialog_message(OSDIALOG_WARNING, OSDIALOG_OK, message.c_str());
+		}
+	}
+
+	// Choose a capture file and start recording or replaying it (UI thread)
+	static void captureFile(HydraQuartetVCO* module, bool record) {
+		osdialog_filters* filters = osdialog_filters_parse("HydraQuartet capture (.hqcv):hqcv");
+		DEFER({osdialog_filters_free(filters);});
+		char* pathC = osdialog_file(record ? OSDIALOG_SAVE : OSDIALOG_OPEN, NULL, record ? "capture.hqcv" : NULL, filters);
+		if (!pathC)
+			return;
+		std::string path = pathC;
+		std::free(pathC);
+		if (record && system::getExtension(path) != ".hqcv")
+			path += ".hqcv";
+
+		std::string error, warning;
+		bool ok = record
+			? module->startRecording(path, APP->engine->getSampleRate(), error)
+			: module->startReplay(path, APP->engine->getSampleRate(), error, warning);
+		if (!ok)
+			osdialog_message(OSDIALOG_WARNING, OSDIALOG_OK, error.c_str());
+		else if (!warning.empty())
+			osdialog_message(OSDIALOG_WARNING, OSDIALOG_OK, warning.c_str());
+	}
+
+	void appendContextMenu(Menu* menu) override {
+		HydraQuartetVCO* module = getModule<HydraQuartetVCO>();
+
+		menu->addChild(new MenuSeparator);
+		menu->addChild(createSubmenuItem("Tuning", module->tuningName, [=](Menu* menu) {
+			menu->addChild(createMenuItem("Load Scala scale (.scl)...", "", [=]() {
+				loadTuningFile(module, false);
+			}));
+			menu->addChild(createMenuItem("Load keyboard mapping (.kbm)...", "", [=]() {
+				loadTuningFile(module, true);
+			}));
+			menu->addChild(createMenuItem("Clear keyboard mapping", "", [=]() {
+				std::string error;
+				if (!module->loadTuning(module->tuningScl, "", error))
+					osdialog_message(OSDIALOG_WARNING, OSDIALOG_OK, error.c_str());
+			}, module->tuningKbm.empty()));
+			menu->addChild(createMenuItem("Reset to 12-TET", "", [=]() {
+				std::string error;
+				if (!module->loadTuning("", "", error))
+					osdialog_message(OSDIALOG_WARNING, OSDIALOG_OK, error.c_str());
+			}));
+		}));
+
+		menu->addChild(createSubmenuItem("Vibrato", "", [=](Menu* menu) {
+			menu->addChild(new MenuParamSlider(module->paramQuantities[HydraQuartetVCO::VIBRATO_RATE_PARAM]));
+			menu->addChild(new MenuParamSlider(module->paramQuantities[HydraQuartetVCO::VIBRATO_DELAY_PARAM]));
+			menu->addChild(new MenuParamSlider(module->paramQuantities[HydraQuartetVCO::VIBRATO_SPREAD_PARAM]));
+		}));
+
+		menu->addChild(new MenuSeparator);
+		menu->addChild(createMenuLabel("Performance"));
+
+		// Block rendering holds controls for a block (no audio latency) for lower CPU
+		static const int blockSizes[] = {0, 8, 16, 32, 64};
+		float sampleRate = APP->engine->getSampleRate();
+		std::vector<std::string> blockLabels = {"Off (per sample)"};
+		for (int i = 1; i < 5; i++) {
+			blockLabels.push_back(string::f("%d samples (controls held %.2f ms)", blockSizes[i], blockSizes[i] / sampleRate * 1000.f));
+		}
+		menu->addChild(createIndexSubmenuItem("Block rendering", blockLabels,
+			[=]() {
+				for (size_t i = 0; i < 5; i++) {
+					if (blockSizes[i] == module->blockSize)
+						return i;
+				}
+				return (size_t)0;
+			},
+			[=](size_t i) { module->blockSize = blockSizes[i]; }));
+
+		std::vector<std::string> qualityLabels;
+		for (int i = 0; i < MINBLEP_KERNEL_COUNT; i++) {
+			qualityLabels.push_back(string::f("%d-sample edges%s", 2 * MINBLEP_KERNELS[i].z,
+				(i == MINBLEP_DEFAULT_QUALITY) ? " (default)" : ""));
+		}
+		menu->addChild(createIndexSubmenuItem("Anti-aliasing quality", qualityLabels,
+			[=]() { return (size_t)module->minBlepQuality; },
+			[=](size_t i) { module->minBlepQuality = (int)i; }));
+
+		// Oscillator core at 44.1-96 kHz, upsampled to the engine rate. The
+		// upsampler's group delay is (TAPS * factor - 1) / 2 output samples.
+		int factor = HydraQuartetVCO::internalRateFactor(sampleRate);
+		float upsamplerDelay = (HydraQuartetVCO::UPSAMPLER_TAPS * factor - 1) / 2.f / sampleRate;
+		std::string internalRateLabel = (factor > 1)
+			? string::f("%g kHz, %dx fewer renders, %.2f ms latency", sampleRate / factor / 1000.f, factor, upsamplerDelay * 1000.f)
+			: "no effect at this rate";
+		menu->addChild(createBoolMenuItem("Fixed internal render rate", internalRateLabel,
+			[=]() { return module->internalRate; },
+			[=](bool enabled) { module->internalRate = enabled; }));
+
+		// Voices of all batched modules rendered together, packed into full SIMD groups
+		std::string batchLabel = "1 sample latency";
+		if (module->batchOverflow)
+			batchLabel = "batch full";
+		else if (module->blockSize > 0 || (module->internalRate && factor > 1))
+			batchLabel = "inactive while block/internal-rate rendering";
+		menu->addChild(createBoolMenuItem("Batch with other instances", batchLabel,
+			[=]() { return module->batchEnabled; },
+			[=](bool enabled) {
+				module->batchEnabled = enabled;
+				module->batchOverflow = false;
+			}));
+
+		menu->addChild(new MenuSeparator);
+		menu->addChild(createMenuLabel("Diagnostics"));
+
+		menu->addChild(createBoolMenuItem("Voice scope and activity", "",
+			[=]() { return module->scopeEnabled; },
+			[=](bool enabled) { module->scopeEnabled = enabled; }));
+
+		menu->addChild(createBoolMenuItem("Profile process() latency", "",
+			[=]() { return module->profiler.enabled; },
+			[=](bool enabled) { module->profiler.enabled = enabled; }));
+
+		menu->addChild(createIndexSubmenuItem("Stress scenario while profiling",
+			{"Off", "FM depth 2.0 near Nyquist", "Hard sync both ways", "PWM CV threshold sweep", "All combined"},
+			[=]() { return (size_t)module->stressScenario; },
+			[=](size_t scenario) { module->stressScenario = (int)scenario; }));
+
+		// Input capture and replay
+		float seconds = module->recorder.framesRecorded.load() / APP->engine->getSampleRate();
+		if (module->recorder.recording.load()) {
+			menu->addChild(createMenuItem("Stop recording inputs", string::f("%.1f s", seconds), [=]() {
+				module->recorder.stop();
+			}));
+		}
+		else {
+			menu->addChild(createMenuItem("Record inputs...", "", [=]() {
+				captureFile(module, true);
+			}));
+			if (module->recorder.overrun.load())
+				menu->addChild(createMenuLabel(string::f("Recording stopped after %.1f s: disk writer fell behind", seconds)));
+		}
+
+		int replayState = module->replayState.load(std::memory_order_acquire);
+		if (replayState == HydraQuartetVCO::REPLAY_START || replayState == HydraQuartetVCO::REPLAY_RUNNING) {
+			menu->addChild(createMenuItem("Stop replay", "", [=]() {
+				module->stopReplay();
+			}));
+		}
+		else {
+			menu->addChild(createMenuItem("Replay captured inputs...", "", [=]() {
+				captureFile(module, false);
+			}, module->recorder.recording.load()));
+		}
+		if (replayState == HydraQuartetVCO::REPLAY_DONE) {
+			const CvReplay& r = module->replay;
+			if (r.mismatches == 0)
+				menu->addChild(createMenuLabel(string::f("Last replay: %llu frames, bit-exact", (unsigned long long)r.frames)));
+			else
+				menu->addChild(createMenuLabel(string::f("Last replay: %llu of %llu frames differ (first at frame %lld)",
+					(unsigned long long)r.mismatches, (unsigned long long)r.frames, (long long)r.firstMismatch)));
+		}
+
+		if (hasLatencyReport) {
+			const LatencyReport& r = latencyReport;
+			// Time available for one 64-sample buffer at the current engine rate
+			float budgetUs = LatencyProfiler::BLOCK_SIZE / APP->engine->getSampleRate() * 1e6f;
+			menu->addChild(createMenuLabel(string::f("Sample: p50 %.2f us, p99 %.2f us, p99.9 %.2f us, max %.2f us",
+				r.p50Ns * 1e-3, r.p99Ns * 1e-3, r.p999Ns * 1e-3, r.maxNs * 1e-3)));
+			menu->addChild(createMenuLabel(string::f("64-sample block: p99 %.1f us, max %.1f us (budget %.0f us)",
+				r.blockP99Ns * 1e-3, r.blockMaxNs * 1e-3, budgetUs)));
+			menu->addChild(createMenuLabel(string::f("Subnormals: %llu outputs, %d in DSP state",
+				(unsigned long long)r.subnormalOutputs, r.subnormalState)));
+		}
+	}
 };
 
 
@@ -0,0 +1,172 @@
+#pragma once
+#include "plugin.hpp"
+#include "Telemetry.hpp"
+#include <atomic>
+#include <cfloat>
+#include <cstdint>
+
+// Worst-case latency profiling for Module::process()
+// Average CPU hides the spikes that cause dropouts, so per-sample execution
+// time is binned into a log-spaced histogram and reported as p50/p99/p99.9/max.
+// A second histogram accumulates 64-sample blocks (typical small audio buffer).
+// Everything here runs on the audio thread: fixed-size arrays, no allocation.
+
+// Log-spaced histogram: 8 linear sub-bins per octave from 8ns up to ~8ms
+struct LatencyHistogram {
+	static constexpr int BINS_PER_OCTAVE = 8;
+	static constexpr int MIN_OCTAVE = 3;  // 2^3 = 8ns
+	static constexpr int NUM_OCTAVES = 20;
+	static constexpr int NUM_BINS = NUM_OCTAVES * BINS_PER_OCTAVE;
+
+	uint32_t bins[NUM_BINS] = {};
+	uint64_t count = 0;
+	int64_t totalNs = 0;
+	int64_t maxNs = 0;
+
+	void reset() {
+		std::memset(bins, 0, sizeof(bins));
+		count = 0;
+		totalNs = 0;
+		maxNs = 0;
+	}
+
+	// Integer-only bin lookup (no log2 on the audio thread)
+	static int binIndex(int64_t ns) {
+		if (ns < (int64_t(1) << MIN_OCTAVE))
+			return 0;
+		int msb = 63 - __builtin_clzll((unsigned long long)ns);
+		int sub = (int)(ns >> (msb - 3)) & (BINS_PER_OCTAVE - 1);
+		int index = (msb - MIN_OCTAVE) * BINS_PER_OCTAVE + sub;
+		return std::min(index, NUM_BINS - 1);
+	}
+
+	// Upper edge of a bin in nanoseconds
+	static double binUpperNs(int index) {
+		int octave = index / BINS_PER_OCTAVE + MIN_OCTAVE;
+		int sub = index % BINS_PER_OCTAVE;
+		return std::ldexp(1.0 + (sub + 1) / (double)BINS_PER_OCTAVE, octave);
+	}
+
+	void record(int64_t ns) {
+		if (ns < 0) ns = 0;
+		bins[binIndex(ns)]++;
+		count++;
+		totalNs += ns;
+		maxNs = std::max(maxNs, ns);
+	}
+
+	// q: quantile in [0, 1]
+	// Returns the upper edge of the bin holding the quantile (conservative),
+	// never more than the observed maximum
+	double percentileNs(double q) const {
+		if (count == 0)
+			return 0.0;
+		uint64_t target = (uint64_t)std::ceil(q * (double)count);
+		target = std::max<uint64_t>(target, 1);
+		uint64_t cumulative = 0;
+		for (int i = 0; i < NUM_BINS; i++) {
+			cumulative += bins[i];
+			if (cumulative >= target)
+				return std::min(binUpperNs(i), (double)maxNs);
+		}
+		return (double)maxNs;
+	}
+
+	double meanNs() const {
+		return (count > 0) ? (double)totalNs / (double)count : 0.0;
+	}
+};
+
+// Snapshot published to the UI thread at the end of each report period
+struct LatencyReport {
+	uint64_t samples = 0;
+	double meanNs = 0.0;
+	double p50Ns = 0.0;
+	double p99Ns = 0.0;
+	double p999Ns = 0.0;
+	double maxNs = 0.0;
+	// Cost of 64 consecutive samples (one small audio buffer)
+	double blockP99Ns = 0.0;
+	double blockMaxNs = 0.0;
+	// Denormal detection: subnormal output samples during the period,
+	// and subnormal values found in DSP state at the end of the period
+	uint64_t subnormalOutputs = 0;
+	int subnormalState = 0;
+};
+
+// True for nonzero floats below FLT_MIN (these hit the slow microcode path
+// when flush-to-zero/denormals-are-zero are not enabled)
+inline bool isSubnormal(float x) {
+	return x != 0.f && std::fabs(x) < FLT_MIN;
+}
+
+inline int countSubnormals(const float* x, int n) {
+	int count = 0;
+	for (int i = 0; i < n; i++) {
+		if (isSubnormal(x[i]))
+			count++;
+	}
+	return count;
+}
+
+struct LatencyProfiler {
+	static constexpr int BLOCK_SIZE = 64;
+	static constexpr float REPORT_SECONDS = 2.f;
+
+	// Toggled from the context menu
+	bool enabled = false;
+
+	LatencyHistogram sampleHistogram;
+	LatencyHistogram blockHistogram;
+	int64_t blockAccumNs = 0;
+	int blockPos = 0;
+	uint64_t subnormalOutputs = 0;
+
+	// Audio -> UI: finished reports (dropped if the UI has not caught up)
+	SpscRing<LatencyReport, 4> reports;
+
+	void reset() {
+		sampleHistogram.reset();
+		blockHistogram.reset();
+		blockAccumNs = 0;
+		blockPos = 0;
+		subnormalOutputs = 0;
+	}
+
+	void record(int64_t ns) {
+		sampleHistogram.record(ns);
+		blockAccumNs += ns;
+		if (++blockPos >= BLOCK_SIZE) {
+			blockHistogram.record(blockAccumNs);
+			blockAccumNs = 0;
+			blockPos = 0;
+		}
+	}
+
+	void checkOutputs(const float* x, int n) {
+		subnormalOutputs += countSubnormals(x, n);
+	}
+
+	bool reportDue(float sampleRate) const {
+		return sampleHistogram.count >= (uint64_t)(sampleRate * REPORT_SECONDS);
+	}
+
+	// subnormalState: result of scanning the module's DSP state
+	void publish(int subnormalState) {
+		LatencyReport* report = reports.producerSlot();
+		if (report) {
+			report->samples = sampleHistogram.count;
+			report->meanNs = sampleHistogram.meanNs();
+			report->p50Ns = sampleHistogram.percentileNs(0.5);
+			report->p99Ns = sampleHistogram.percentileNs(0.99);
+			report->p999Ns = sampleHistogram.percentileNs(0.999);
+			report->maxNs = (double)sampleHistogram.maxNs;
+			report->blockP99Ns = blockHistogram.percentileNs(0.99);
+			report->blockMaxNs = (double)blockHistogram.maxNs;
+			report->subnormalOutputs = subnormalOutputs;
+			report->subnormalState = subnormalState;
+			reports.produce();
+		}
+		reset();
+	}
+};
@@ -0,0 +1,77 @@
+// Generated by scripts/generate_minblep_tables.py - do not edit.
+// MinBLEP residual tables (step - 1) in polyphase layout [O + 1][2 * Z].
+#pragma once
+
+alignas(64) static const float MINBLEP_Z4_O16[17][8] = {
+	{-9.999998905e-01f, -9.852299985e-01f, -5.424344618e-01f, 1.434036989e-01f, -3.190185688e-02f, 5.626827539e-03f, -6.470923445e-04f, 1.786633434e-05f},
+	{-9.999992378e-01f, -9.795949773e-01f, -4.853751870e-01f, 1.451147128e-01f, -3.395683496e-02f, 5.690676600e-03f, -5.536987743e-04f, 9.964890463e-06f},
+	{-9.999968491e-01f, -9.723266585e-01f, -4.264883954e-01f, 1.418629405e-01f, -3.418388917e-02f, 5.410040396e-03f, -4.453783765e-04f, 4.023481483e-06f},
+	{-9.999901333e-01f, -9.631115174e-01f, -3.665439913e-01f, 1.343017604e-01f, -3.286084990e-02f, 4.875645883e-03f, -3.346400884e-04f, -6.540336828e-09f},
+	{-9.999741492e-01f, -9.516173467e-01f, -3.063860435e-01f, 1.231698075e-01f, -3.029730679e-02f, 4.174947823e-03f, -2.308696675e-04f, -2.362837097e-06f},
+	{-9.999403328e-01f, -9.375022773e-01f, -2.469085630e-01f, 1.092601023e-01f, -2.681556780e-02f, 3.387426483e-03f, -1.403724693e-04f, -3.388225861e-06f},
+	{-9.998748001e-01f, -9.204260601e-01f, -1.890277315e-01f, 9.338796642e-02f, -2.273319380e-02f, 2.581220989e-03f, -6.665337219e-05f, -3.463942354e-06f},
+	{-9.997561959e-01f, -9.000633538e-01f, -1.336517038e-01f, 7.635928515e-02f, -1.834788103e-02f, 1.811087046e-03f, -1.085419553e-05f, -2.956951003e-06f},
+	{-9.995531192e-01f, -8.761186713e-01f, -8.164931170e-02f, 5.894065405e-02f, -1.392526108e-02f, 1.117597545e-03f, 2.771633838e-05f, -2.185526381e-06f},
+	{-9.992210970e-01f, -8.483424202e-01f, -3.381910109e-02f, 4.183276484e-02f, -9.689956985e-03f, 5.274154997e-04f, 5.103208621e-05f, -1.396223994e-06f},
+	{-9.986992409e-01f, -8.165473705e-01f, 9.139798944e-03f, 2.564820094e-02f, -5.820015255e-03f, 5.444012787e-05f, 6.182578646e-05f, -7.487209244e-07f},
+	{-9.979066844e-01f, -7.806247407e-01f, 4.665354139e-02f, 1.089449611e-02f, -2.444617722e-03f, -2.984182218e-04f, 6.313524218e-05f, -3.181052270e-07f},
+	{-9.967389874e-01f, -7.405590187e-01f, 7.829482912e-02f, -2.036976373e-03f, 3.552049815e-04f, -5.370630113e-04f, 5.793955321e-05f, -9.443333882e-08f},
+	{-9.950647601e-01f, -6.964406044e-01f, 1.037984835e-01f, -1.287608931e-02f, 2.543284829e-03f, -6.738722982e-04f, 4.890018765e-05f, -1.056496335e-08f},
+	{-9.927227639e-01f, -6.484753621e-01f, 1.230704686e-01f, -2.147313629e-02f, 4.122985701e-03f, -7.253867436e-04f, 3.820174125e-05f, 2.659739540e-09f},
+	{-9.895198420e-01f, -5.969902693e-01f, 1.361898724e-01f, -2.779254842e-02f, 5.130420795e-03f, -7.101896829e-04f, 2.748815827e-05f, 0.000000000e+00f},
+	{-9.852299985e-01f, -5.424344618e-01f, 1.434036989e-01f, -3.190185688e-02f, 5.626827539e-03f, -6.470923445e-04f, 1.786633434e-05f, 0.000000000e+00f},
+};
+
+alignas(64) static const float MINBLEP_Z8_O16[17][16] = {
+	{-9.999999472e-01f, -9.968655541e-01f, -8.511378945e-01f, -1.389472345e-01f, 1.607089392e-01f, -1.060937287e-01f, 6.237768134e-02f, -3.381146301e-02f, 1.670359184e-02f, -7.386903413e-03f, 2.831280895e-03f, -9.005370087e-04f, 2.119935916e-04f, -2.708387560e-05f, -1.524246747e-06f, 8.924043637e-07f},
+	{-9.999997075e-01f, -9.956233633e-01f, -8.252290785e-01f, -8.802085855e-02f, 1.399162797e-01f, -9.943800404e-02f, 6.060244460e-02f, -3.333905962e-02f, 1.641906368e-02f, -7.105724639e-03f, 2.608936856e-03f, -7.731477914e-04f, 1.604770959e-04f, -1.349083756e-05f, -3.285958852e-06f, 7.499878021e-07f},
+	{-9.999989884e-01f, -9.939862289e-01f, -7.963431590e-01f, -3.949957733e-02f, 1.165959966e-01f, -8.999500072e-02f, 5.681563207e-02f, -3.165203722e-02f, 1.550549923e-02f, -6.552253096e-03f, 2.294490119e-03f, -6.255311203e-04f, 1.086519160e-04f, -1.625551993e-06f, -4.434965404e-06f, 5.617218892e-07f},
+	{-9.999972057e-01f, -9.918590733e-01f, -7.644078987e-01f, 6.002107081e-03f, 9.148013577e-02f, -7.821210625e-02f, 5.127421417e-02f, -2.890313314e-02f, 1.405459822e-02f, -5.778252925e-03f, 1.913380538e-03f, -4.677446545e-04f, 5.935306328e-05f, 8.114675302e-06f, -5.017020343e-06f, 3.621757627e-07f},
+	{-9.999932991e-01f, -9.891319567e-01f, -7.293961197e-01f, 4.790252419e-02f, 6.532451812e-02f, -6.459236559e-02f, 4.428403951e-02f, -2.527580903e-02f, 1.217265454e-02f, -4.840096663e-03f, 1.491276091e-03f, -3.090449481e-04f, 1.485389661e-05f, 1.552948626e-05f, -5.107908689e-06f, 1.810865367e-07f},
+	{-9.999854945e-01f, -9.856795685e-01f, -6.913318202e-01f, 8.566827951e-02f, 3.888821668e-02f, -4.967597384e-02f, 3.618611194e-02f, -2.097498554e-02f, 9.974913073e-03f, -3.795804581e-03f, 1.052822409e-03f, -1.575162469e-04f, -2.317865703e-05f, 2.059495892e-05f, -4.803090004e-06f, 3.858505382e-08f},
+	{-9.999709576e-01f, -9.813611171e-01f, -6.502955532e-01f, 1.188291696e-01f, 1.291281383e-02f, -3.402101122e-02f, 2.734217709e-02f, -1.621747650e-02f, 7.579973039e-03f, -2.702279344e-03f, 6.205766292e-04f, -1.980429017e-05f, -5.368847057e-05f, 2.343493275e-05f, -4.207622736e-06f, -5.638187772e-08f},
+	{-9.999453715e-01f, -9.760207078e-01f, -6.064287986e-01f, 1.469920668e-01f, -1.189788605e-02f, -1.818411232e-02f, 1.812019922e-02f, -1.122253859e-02f, 5.104479080e-03f, -1.612847224e-03f, 2.141563776e-04f, 9.904105194e-05f, -7.619918836e-05f, 2.428873873e-05f, -3.426594538e-06f, -1.039563043e-07f},
+	{-9.999023954e-01f, -9.694882812e-01f, -5.599370897e-01f, 1.698532829e-01f, -3.489701895e-02f, -2.701762150e-03f, 8.880298042e-03f, -6.202917053e-03f, 2.658311796e-03f, -5.751926092e-04f, -1.503740372e-04f, 1.956208907e-04f, -9.075522377e-05f, 2.347582923e-05f, -2.558283367e-06f, -1.127689163e-07f},
+	{-9.998330035e-01f, -9.615811894e-01f, -5.110916503e-01f, 1.872089452e-01f, -5.551205686e-02f, 1.192713015e-02f, -3.833073606e-05f, -1.356733695e-03f, 3.404524493e-04f, 3.702528040e-04f, -4.608771736e-04f, 2.681479165e-04f, -9.784102505e-05f, 2.136221799e-05f, -1.688616504e-06f, -9.693691305e-08f},
+	{-9.997246992e-01f, -9.521064579e-01f, -4.602293521e-01f, 1.989629678e-01f, -7.325985249e-02f, 2.525678058e-02f, -8.329039891e-03f, 3.139498819e-03f, -1.764346602e-03f, 1.191432616e-03f, -7.092799601e-04f, 3.163277683e-04f, -9.828710759e-05f, 1.832903268e-05f, -8.870757959e-07f, -7.014317027e-08f},
+	{-9.995605977e-01f, -9.408637809e-01f, -4.077508213e-01f, 2.051322561e-01f, -8.775882268e-02f, 3.690769076e-02f, -1.572751400e-02f, 7.136509867e-03f, -3.587999662e-03f, 1.865291269e-03f, -8.914963985e-04f, 3.411754519e-04f, -9.316951896e-05f, 1.474584845e-05f, -2.050520943e-07f, -4.397522824e-08f},
+	{-9.993183906e-01f, -9.276492565e-01f, -3.541165927e-01f, 2.058488736e-01f, -9.873786182e-02f, 4.657700318e-02f, -2.201940687e-02f, 1.051640161e-02f, -5.080594465e-03f, 2.377920280e-03f, -1.007159524e-03f, 3.447864743e-04f, -8.371007783e-05f, 1.094910849e-05f, 3.256119063e-07f, -2.156787349e-08f},
+	{-9.989691899e-01f, -9.122598586e-01f, -2.998412528e-01f, 2.013589816e-01f, -1.060416855e-01f, 5.404575376e-02f, -2.704563689e-02f, 1.319519577e-02f, -6.210973652e-03f, 2.724261721e-03f, -1.059200030e-03f, 3.300789679e-04f, -7.118271102e-05f, 7.226404157e-06f, 6.911060020e-07f, -3.976839635e-09f},
+	{-9.984762871e-01f, -8.944985974e-01f, -2.454855936e-01f, 1.920184761e-01f, -1.096324367e-01f, 5.918284619e-02f, -3.070523865e-02f, 1.512379306e-02f, -6.966438566e-03f, 2.907426490e-03f, -1.053306584e-03f, 3.005260137e-04f, -5.683115467e-05f, 3.806369389e-06f, 8.940916714e-07f, 4.861528957e-10f},
+	{-9.977938411e-01f, -8.741802988e-01f, -1.916468565e-01f, 1.782853515e-01f, -1.095875147e-01f, 6.194570370e-02f, -3.295578242e-02f, 1.628740594e-02f, -7.351659033e-03f, 2.937695090e-03f, -9.973112360e-04f, 2.598928953e-04f, -4.180012234e-05f, 8.550295423e-07f, 9.518734980e-07f, 0.000000000e+00f},
+	{-9.968655541e-01f, -8.511378945e-01f, -1.389472345e-01f, 1.607089392e-01f, -1.060937287e-01f, 6.237768134e-02f, -3.381146301e-02f, 1.670359184e-02f, -7.386903413e-03f, 2.831280895e-03f, -9.005370087e-04f, 2.119935916e-04f, -2.708387560e-05f, -1.524246747e-06f, 8.924043637e-07f, 0.000000000e+00f},
+};
+
+alignas(64) static const float MINBLEP_Z16_O16[17][32] = {
+	{-9.999999653e-01f, -9.989885674e-01f, -9.444526774e-01f, -5.207222402e-01f, 1.625173995e-01f, 1.655597441e-02f, -6.983082018e-02f, 7.600870127e-02f, -6.735819409e-02f, 5.535826851e-02f, -4.382943441e-02f, 3.387318625e-02f, -2.566579711e-02f, 1.907355821e-02f, -1.388789828e-02f, 9.883933078e-03f, -6.858823617e-03f, 4.622870535e-03f, -3.016116192e-03f, 1.892095174e-03f, -1.134409877e-03f, 6.442095507e-04f, -3.414098313e-04f, 1.650919468e-04f, -7.006922088e-05f, 2.400401904e-05f, -4.908587454e-06f, -1.082200558e-06f, 1.848144584e-06f, -1.129573655e-06f, 3.224125857e-07f, 2.212155814e-08f},
+	{-9.999998335e-01f, -9.985895734e-01f, -9.335820707e-01f, -4.756432000e-01f, 1.835203355e-01f, -9.644097691e-03f, -5.143915795e-02f, 6.500884462e-02f, -6.137174476e-02f, 5.241625685e-02f, -4.260843006e-02f, 3.354587750e-02f, -2.573904996e-02f, 1.927075686e-02f, -1.406971510e-02f, 9.995138196e-03f, -6.892206959e-03f, 4.594913665e-03f, -2.951241281e-03f, 1.813261869e-03f, -1.058412596e-03f, 5.808852498e-04f, -2.944125425e-04f, 1.336864279e-04f, -5.118938514e-05f, 1.390853602e-05f, -2.239083419e-07f, -2.875791830e-06f, 2.335680326e-06f, -1.141156280e-06f, 2.441838578e-07f, 3.167949614e-08f},
+	{-9.999994817e-01f, -9.980609148e-01f, -9.211045860e-01f, -4.290681181e-01f, 1.999014956e-01f, -3.455077749e-02f, -3.220120916e-02f, 5.232085865e-02f, -5.353637499e-02f, 4.776101016e-02f, -3.991825694e-02f, 3.201623613e-02f, -2.486211410e-02f, 1.873985817e-02f, -1.371039469e-02f, 9.716937085e-03f, -6.655139506e-03f, 4.386488045e-03f, -2.771371943e-03f, 1.665059863e-03f, -9.432941452e-04f, 4.973412159e-04f, -2.381905893e-04f, 9.888331705e-05f, -3.160825412e-05f, 4.091995222e-06f, 4.011449886e-06f, -4.337769228e-06f, 2.645233671e-06f, -1.083420775e-06f, 1.600496862e-07f, 3.554691852e-08f},
+	{-9.999986885e-01f, -9.973691255e-01f, -9.068794255e-01f, -3.812978120e-01f, 2.115427293e-01f, -5.761177864e-02f, -1.267765135e-02f, 3.837895978e-02f, -4.415638288e-02f, 4.159715318e-02f, -3.589495588e-02f, 2.937567863e-02f, -2.309829245e-02f, 1.752666595e-02f, -1.284466246e-02f, 9.076625184e-03f, -6.169440588e-03f, 4.014962410e-03f, -2.490027998e-03f, 1.457634805e-03f, -7.963127129e-04f, 3.984778845e-04f, -1.758325394e-04f, 6.247482188e-05f, -1.226378451e-05f, -5.018207469e-06f, 7.639749512e-06f, -5.430334920e-06f, 2.780083804e-06f, -9.679058081e-07f, 7.745357156e-08f, 3.500983570e-08f},
+	{-9.999970801e-01f, -9.964744092e-01f, -8.907695794e-01f, -3.326719633e-01f, 2.184018482e-01f, -7.832674433e-02f, 6.573566948e-03f, 2.364705550e-02f, -3.358015341e-02f, 3.417633172e-02f, -3.071841484e-02f, 2.575349346e-02f, -2.054186822e-02f, 1.570119574e-02f, -1.152536263e-02f, 8.114461591e-03f, -5.465757692e-03f, 3.503383306e-03f, -2.124134773e-03f, 1.202995996e-03f, -6.256172833e-04f, 2.895268425e-04f, -1.104758523e-04f, 2.618883225e-05f, 5.992936805e-06f, -1.306487959e-05f, 1.054716384e-05f, -6.137835565e-06f, 2.752343439e-06f, -8.083760000e-07f, 2.803174137e-09f, 3.158627737e-08f},
+	{-9.999940557e-01f, -9.953299643e-01f, -8.726449374e-01f, -2.835659340e-01f, 2.205159941e-01f, -9.625909228e-02f, 2.501285708e-02f, 8.603897165e-03f, -2.218780602e-02f, 2.578749415e-02f, -2.460487417e-02f, 2.131107392e-02f, -1.731364203e-02f, 1.335419955e-02f, -9.820746155e-03f, 6.881563894e-03f, -4.581955326e-03f, 2.879270764e-03f, -1.693151700e-03f, 9.144118261e-04f, -4.398492883e-04f, 1.758045693e-04f, -4.516624505e-05f, -8.383352585e-06f, 2.242957313e-05f, -1.977170348e-05f, 1.266518779e-05f, -6.465375654e-06f, 2.581414503e-06f, -6.198410056e-07f, -5.904557221e-08f, 2.639576269e-08f},
+	{-9.999886883e-01f, -9.938813450e-01f, -8.523856677e-01f, -2.343865428e-01f, 2.180033329e-01f, -1.110464026e-01f, 4.213403864e-02f, -6.272066441e-03f, -1.037798123e-02f, 1.674606458e-02f, -1.779829675e-02f, 1.623511823e-02f, -1.355560315e-02f, 1.059301097e-02f, -7.811258576e-03f, 5.437459088e-03f, -3.561285929e-03f, 2.173289853e-03f, -1.218141619e-03f, 6.057861536e-04f, -2.477471656e-04f, 6.247822326e-05f, 1.726926160e-05f, -3.984789322e-05f, 3.645645404e-05f, -2.494920051e-05f, 1.396972932e-05f, -6.436510817e-06f, 2.292237251e-06f, -4.175492606e-07f, -1.051024360e-07f, 1.958489837e-08f},
+	{-9.999795941e-01f, -9.920658837e-01f, -8.298858117e-01f, -1.855668184e-01f, 2.110629546e-01f, -1.224090379e-01f, 5.747836206e-02f, -2.051765210e-02f, 1.445779322e-03f, 7.382406162e-03f, -1.056093826e-02f, 1.073007439e-02f, -9.424960286e-03f, 7.536892488e-03f, -5.585970948e-03f, 3.847401227e-03f, -2.450425547e-03f, 1.417858221e-03f, -7.208222185e-04f, 2.910429978e-04f, -5.777046654e-05f, -4.564703209e-05f, 7.433098182e-05f, -6.705589199e-05f, 4.764208481e-05f, -2.849604757e-05f, 1.447818527e-05f, -6.090155017e-06f, 1.913553163e-06f, -2.157971301e-07f, -1.337929355e-07f, 1.241145542e-08f},
+	{-9.999647723e-01f, -9.898122050e-01f, -8.050570279e-01f, -1.375597795e-01f, 1.999728987e-01f, -1.301567282e-01f, 7.064708864e-02f, -3.369924688e-02f, 1.288859521e-02f, -1.970008819e-03f, -3.163476307e-03f, 5.010128414e-03f, -5.087776273e-03f, 4.312079540e-03f, -3.238806109e-03f, 2.179571229e-03f, -1.297459325e-03f, 6.457493600e-04f, -2.226399441e-04f, -1.645513962e-05f, 1.222414542e-04f, -1.443113758e-04f, 1.239332054e-04f, -8.913641883e-05f, 5.572005639e-05f, -3.039622070e-05f, 1.424462884e-05f, -5.477208243e-06f, 1.475841883e-06f, -2.738759675e-08f, -1.454429391e-07f, 5.344111376e-09f},
+	{-9.999413970e-01f, -9.870398622e-01f, -7.778324073e-01f, -9.083132030e-02f, 1.850862776e-01f, -1.341929049e-01f, 8.131225309e-02f, -4.542600162e-02f, 2.357729490e-02f, -1.098630043e-02f, 4.124934708e-03f, -7.089547776e-04f, -7.124587935e-04f, 1.046722335e-03f, -8.647151493e-04f, 5.022748336e-04f, -1.498999655e-04f, -1.112509883e-04f, 2.560964783e-04f, -3.044325381e-04f, 2.853637346e-04f, -2.299480932e-04f, 1.644666279e-04f, -1.055144855e-04f, 6.058787317e-05f, -3.071224859e-05f, 1.335376835e-05f, -4.656759311e-06f, 1.009571615e-06f, 1.371151548e-07f, -1.418871902e-07f, -1.073165445e-09f},
+	{-9.999055690e-01f, -9.836591313e-01f, -7.481702718e-01f, -4.585231151e-02f, 1.668255167e-01f, -1.345166268e-01f, 8.922528544e-02f, -5.536149887e-02f, 3.317251358e-02f, -1.936134445e-02f, 1.104631987e-02f, -6.217830913e-03f, 3.536641643e-03f, -2.134076379e-03f, 1.444044191e-03f, -1.118750009e-03f, 9.471822557e-04f, -8.235829813e-04f, 6.969898804e-04f, -5.621502094e-04f, 4.258233487e-04f, -2.997916981e-04f, 1.948353309e-04f, -1.159143678e-04f, 6.229826179e-05f, -2.957535693e-05f, 1.191393172e-05f, -3.692282682e-06f, 5.435718602e-07f, 2.698754062e-07f, -1.260743131e-07f, -5.819230875e-09f},
+	{-9.998520156e-01f, -9.795709959e-01f, -7.160578562e-01f, -3.090055542e-03f, 1.456747852e-01f, -1.312220093e-01f, 9.422323386e-02f, -6.323353161e-02f, 4.137944353e-02f, -2.682001290e-02f, 1.736290645e-02f, -1.132112233e-02f, 7.505286688e-03f, -5.112938936e-03f, 3.601385157e-03f, -2.622813443e-03f, 1.952847461e-03f, -1.464999599e-03f, 1.084208583e-03f, -7.807656357e-04f, 5.391728118e-04f, -3.519441471e-04f, 2.144684818e-04f, -1.203491360e-04f, 6.104400761e-05f, -2.717319351e-05f, 1.004954212e-05f, -2.647999498e-06f, 1.036161166e-07f, 3.660152252e-07f, -1.016807835e-07f, -7.429173721e-09f},
+	{-9.997737386e-01f, -9.746673593e-01f, -6.815147670e-01f, 3.700073698e-02f, 1.221707436e-01f, -1.244951356e-01f, 9.623240193e-02f, -6.884169330e-02f, 4.795688984e-02f, -3.312614645e-02f, 2.286519810e-02f, -1.584424079e-02f, 1.105483790e-02f, -7.784434493e-03f, 5.530497920e-03f, -3.956451639e-03f, 2.831731869e-03f, -2.013465174e-03f, 1.404999343e-03f, -9.535922320e-04f, 6.223965292e-04f, -3.853990113e-04f, 2.233079138e-04f, -1.190979238e-04f, 5.713750796e-05f, -2.373593978e-05f, 7.893502965e-06f, -1.585550017e-06f, -2.886848949e-07f, 4.236630478e-07f, -7.264262858e-08f, -4.639783557e-09f},
+	{-9.996616052e-01f, -9.688315139e-01f, -6.445961062e-01f, 7.398725776e-02f, 9.689178804e-02f, -1.146085041e-01f, 9.526929343e-02f, -7.206255245e-02f, 5.272434663e-02f, -3.808996403e-02f, 2.737882730e-02f, -1.963925099e-02f, 1.406698535e-02f, -1.005869646e-02f, 7.166475628e-03f, -5.075227650e-03f, 3.555203631e-03f, -2.451837628e-03f, 1.650045422e-03f, -1.076253103e-03f, 6.739493544e-04f, -4.000251928e-04f, 2.217738619e-04f, -1.126728354e-04f, 5.098644433e-05f, -1.952159682e-05f, 5.579874443e-06f, -5.611377606e-07f, -6.166985758e-07f, 4.437313494e-07f, -4.285597288e-08f, 1.061557064e-09f},
+	{-9.995038828e-01f, -9.619389014e-01f, -6.053951453e-01f, 1.074679855e-01f, 7.044601522e-02f, -1.019131367e-01f, 9.143884073e-02f, -7.285226637e-02f, 5.556688069e-02f, -4.157367607e-02f, 3.076996293e-02f, -2.258958070e-02f, 1.644755916e-02f, -1.186431574e-02f, 8.458374884e-03f, -5.945098860e-03f, 4.102194821e-03f, -2.768317024e-03f, 1.813662867e-03f, -1.146728642e-03f, 6.937297285e-04f, -3.965135844e-04f, 2.107118449e-04f, -1.017778020e-04f, 4.306699852e-05f, -1.480122798e-05f, 3.237189776e-06f, 3.767915622e-07f, -8.692105508e-07f, 4.295612424e-07f, -1.590299337e-08f, 5.020270866e-10f},
+	{-9.992857185e-01f, -9.538581882e-01f, -5.640454348e-01f, 1.370819164e-01f, 4.345818321e-02f, -8.682854549e-02f, 8.492997773e-02f, -7.124657387e-02f, 5.643768769e-02f, -4.349513545e-02f, 3.294910818e-02f, -2.461343154e-02f, 1.812930644e-02f, -1.315042180e-02f, 9.370650766e-03f, -6.543314030e-03f, 4.459690531e-03f, -2.956653243e-03f, 1.893835441e-03f, -1.165301886e-03f, 6.829926141e-04f, -3.762913529e-04f, 1.913244395e-04f, -8.726181662e-05f, 3.389611046e-05f, -9.844823749e-06f, 9.827412768e-07f, 1.189355719e-06f, -1.040345585e-06f, 3.867962215e-07f, 6.179806888e-09f, 0.000000000e+00f},
+	{-9.989885674e-01f, -9.444526774e-01f, -5.207222402e-01f, 1.625173995e-01f, 1.655597441e-02f, -6.983082018e-02f, 7.600870127e-02f, -6.735819409e-02f, 5.535826851e-02f, -4.382943441e-02f, 3.387318625e-02f, -2.566579711e-02f, 1.907355821e-02f, -1.388789828e-02f, 9.883933078e-03f, -6.858823617e-03f, 4.622870535e-03f, -3.016116192e-03f, 1.892095174e-03f, -1.134409877e-03f, 6.442095507e-04f, -3.414098313e-04f, 1.650919468e-04f, -7.006922088e-05f, 2.400401904e-05f, -4.908587454e-06f, -1.082200558e-06f, 1.848144584e-06f, -1.129573655e-06f, 3.224125857e-07f, 2.212155814e-08f, 0.000000000e+00f},
+};
+
+struct MinBlepKernel {
+	int z;  // Zero crossings (step length is 2 * z samples)
+	int o;  // Phases per sample
+	const float* table;  // [o + 1][2 * z]
+};
+
+static const MinBlepKernel MINBLEP_KERNELS[] = {
+	{4, 16, &MINBLEP_Z4_O16[0][0]},
+	{8, 16, &MINBLEP_Z8_O16[0][0]},
+	{16, 16, &MINBLEP_Z16_O16[0][0]},
+};
+static constexpr int MINBLEP_KERNEL_COUNT = 3;
+static constexpr int MINBLEP_MAX_Z = 16;
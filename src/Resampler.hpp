@@ -0,0 +1,97 @@
+#pragma once
+#include "plugin.hpp"
+#include <cmath>
+#include <cstring>
+
+using simd::float_4;
+
+// Integer-ratio polyphase upsampler for float_4 streams
+// Each input frame produces `factor` output frames. Phase p of the output is a
+// TAPS-long FIR over the input history using every factor-th coefficient of a
+// Kaiser-windowed sinc prototype, so zero-stuffed samples are never multiplied.
+// The passband ends at the input Nyquist; images of the input band land above
+// it, which at factor >= 2 means above ~24 kHz.
+// Group delay is (TAPS * factor - 1) / 2 output samples.
+template <int MAX_FACTOR, int TAPS, int STREAMS>
+struct PolyphaseUpsampler {
+	static constexpr float KAISER_BETA = 6.f;  // ~60 dB stopband
+
+	int factor = 1;
+	// Coefficients per phase, reversed so they line up with the history
+	alignas(16) float kernel[MAX_FACTOR][TAPS];
+	// History is written twice (pos and pos + TAPS) so every read is contiguous
+	float_4 history[STREAMS][2 * TAPS];
+	int pos = 0;
+
+	PolyphaseUpsampler() {
+		setFactor(1);
+	}
+
+	void reset() {
+		std::memset(history, 0, sizeof(history));
+		pos = 0;
+	}
+
+	void resetStream(int s) {
+		std::memset(history[s], 0, sizeof(history[s]));
+	}
+
+	// Designs the prototype filter and clears the history
+	// (a few hundred sin/sqrt calls, so only when the ratio changes)
+	void setFactor(int f) {
+		factor = clamp(f, 1, MAX_FACTOR);
+		const int n = TAPS * factor;
+		const double center = 0.5 * (n - 1);
+		const double cutoff = 0.5 / factor;  // Input Nyquist in output cycles/sample
+		const double i0Beta = besselI0(KAISER_BETA);
+		for (int p = 0; p < factor; p++) {
+			double sum = 0.0;
+			double h[TAPS];
+			for (int k = 0; k < TAPS; k++) {
+				double t = k * factor + p - center;
+				double x = 2.0 * cutoff * t;
+				double sinc = (std::abs(x) < 1e-9) ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+				double r = t / (0.5 * n);
+				double window = besselI0(KAISER_BETA * std::sqrt(std::max(0.0, 1.0 - r * r))) / i0Beta;
+				h[k] = sinc * window;
+				sum += h[k];
+			}
+			// Unity DC gain per phase (no ripple at the input frame rate)
+			for (int k = 0; k < TAPS; k++)
+				kernel[p][TAPS - 1 - k] = (float)(h[k] / sum);
+		}
+		reset();
+	}
+
+	// Push one input frame per stream before reading its `factor` phases
+	void push(int s, float_4 x) {
+		history[s][pos] = x;
+		history[s][pos + TAPS] = x;
+	}
+
+	// Advance after all streams have been pushed and read for this frame
+	void advance() {
+		pos = (pos + 1) % TAPS;
+	}
+
+	// Output sample `phase` (0 to factor - 1) for stream s
+	float_4 process(int s, int phase) const {
+		// Oldest sample first: history[pos + 1 .. pos + TAPS]
+		const float_4* x = &history[s][pos + 1];
+		const float* h = kernel[phase];
+		float_4 y = 0.f;
+		for (int k = 0; k < TAPS; k++)
+			y += x[k] * h[k];
+		return y;
+	}
+
+private:
+	static double besselI0(double x) {
+		double sum = 1.0, term = 1.0;
+		for (int k = 1; k < 32; k++) {
+			term *= (x / (2.0 * k)) * (x / (2.0 * k));
+			sum += term;
+		}
+		return sum;
+	}
+};
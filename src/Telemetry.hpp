@@ -0,0 +1,135 @@
+#pragma once
+#include "plugin.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+using simd::float_4;
+
+// Lock-free single-producer/single-consumer ring of fixed-size slots
+// The producer fills a slot in place (no copy, no allocation) and publishes it;
+// the consumer reads slots in order and releases them. Neither side blocks:
+// a full ring makes producerSlot() return nullptr, an empty one consumerSlot().
+template <typename T, int CAPACITY>
+struct SpscRing {
+	static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+	T slots[CAPACITY];
+	// Monotonic counters; each is written by one side only
+	// (padded apart so the two threads do not share a cache line)
+	std::atomic<uint32_t> head{0};  // Producer
+	char padding[64];
+	std::atomic<uint32_t> tail{0};  // Consumer
+
+	// Producer
+	T* producerSlot() {
+		uint32_t h = head.load(std::memory_order_relaxed);
+		if (h - tail.load(std::memory_order_acquire) >= (uint32_t)CAPACITY)
+			return nullptr;
+		return &slots[h & (CAPACITY - 1)];
+	}
+	void produce() {
+		head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	// Consumer
+	const T* consumerSlot() const {
+		uint32_t t = tail.load(std::memory_order_relaxed);
+		if (head.load(std::memory_order_acquire) == t)
+			return nullptr;
+		return &slots[t & (CAPACITY - 1)];
+	}
+	void consume() {
+		tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+};
+
+
+// One scope frame plus the voice activity since the previous frame
+struct TelemetryPacket {
+	static constexpr int POINTS = 64;
+
+	int channels = 0;
+	float duration = 0.f;          // Seconds covered by the event counts
+	float scope[16][POINTS];       // Decimated per-voice audio output
+	uint32_t edges1[16];           // VCO1 cycles completed
+	uint32_t edges2[16];           // VCO2 cycles completed
+	uint32_t syncs[16];            // Hard/soft sync resets applied
+	float fmDepth[16];             // Through-zero FM depth at the end of the frame
+};
+
+
+// Audio-thread side: counts events every sample and captures a scope frame
+// starting at a VCO1 cycle of voice 1, so periodic waveforms stand still
+struct TelemetryCapture {
+	static constexpr float WINDOW_SECONDS = 0.04f;   // Scope frame length
+	static constexpr float HOLDOFF_SECONDS = 0.05f;  // Free-run if no trigger
+
+	SpscRing<TelemetryPacket, 4> ring;
+
+	TelemetryPacket* packet = nullptr;  // Slot being filled, null while waiting
+	int point = 0;
+	int captureChannels = 0;
+	int decimation = 1;
+	int decimationCounter = 0;
+	float waitTime = 0.f;
+	float elapsed = 0.f;
+	uint32_t edges1[16] = {};
+	uint32_t edges2[16] = {};
+	uint32_t syncs[16] = {};
+
+	void countEvents(int g, int wrap1Mask, int wrap2Mask, int syncMask) {
+		for (int i = 0; i < 4; i++) {
+			edges1[g * 4 + i] += (wrap1Mask >> i) & 1;
+			edges2[g * 4 + i] += (wrap2Mask >> i) & 1;
+			syncs[g * 4 + i] += (syncMask >> i) & 1;
+		}
+	}
+
+	// Once per rendered frame, after countEvents() for every group
+	// trigger: voice 1 completed a VCO1 cycle this sample
+	void process(int channels, const float_4* audio, const float_4* fmDepth, bool trigger, float sampleTime) {
+		elapsed += sampleTime;
+
+		if (!packet) {
+			waitTime += sampleTime;
+			if (!trigger && waitTime < HOLDOFF_SECONDS)
+				return;
+			// Skip this frame if the UI has not caught up
+			packet = ring.producerSlot();
+			if (!packet)
+				return;
+			point = 0;
+			captureChannels = channels;
+			decimationCounter = 0;
+			decimation = std::max(1, (int)(WINDOW_SECONDS / (sampleTime * TelemetryPacket::POINTS)));
+		}
+
+		if (decimationCounter-- > 0)
+			return;
+		decimationCounter = decimation - 1;
+
+		// Voices added mid-frame have no complete trace, so they wait for the next one
+		captureChannels = std::min(captureChannels, channels);
+		for (int c = 0; c < captureChannels; c++)
+			packet->scope[c][point] = audio[c / 4][c % 4];
+		if (++point < TelemetryPacket::POINTS)
+			return;
+
+		packet->channels = captureChannels;
+		packet->duration = elapsed;
+		for (int c = 0; c < 16; c++) {
+			packet->edges1[c] = edges1[c];
+			packet->edges2[c] = edges2[c];
+			packet->syncs[c] = syncs[c];
+			packet->fmDepth[c] = (c < captureChannels) ? fmDepth[c / 4][c % 4] : 0.f;
+		}
+		ring.produce();
+		packet = nullptr;
+		waitTime = 0.f;
+		elapsed = 0.f;
+		std::memset(edges1, 0, sizeof(edges1));
+		std::memset(edges2, 0, sizeof(edges2));
+		std::memset(syncs, 0, sizeof(syncs));
+	}
+};
@@ -0,0 +1,246 @@
+#include "Tuning.hpp"
+#include <cstdlib>
+#include <sstream>
+
+
+// Non-comment lines of a Scala file (comments start with '!')
+static std::vector<std::string> scalaLines(const std::string& text) {
+	std::vector<std::string> lines;
+	std::istringstream stream(text);
+	std::string line;
+	while (std::getline(stream, line)) {
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+		if (!line.empty() && line[0] == '!')
+			continue;
+		lines.push_back(line);
+	}
+	return lines;
+}
+
+// Scala ignores everything after the first whitespace-separated token
+static std::string firstToken(const std::string& line) {
+	std::istringstream stream(line);
+	std::string token;
+	stream >> token;
+	return token;
+}
+
+// Pitch value: cents if it contains a period, otherwise a ratio "a/b" or integer "a"
+static bool parsePitch(const std::string& token, double& ratio) {
+	if (token.empty())
+		return false;
+	char* end;
+	if (token.find('.') != std::string::npos) {
+		double cents = std::strtod(token.c_str(), &end);
+		if (*end != '\0')
+			return false;
+		ratio = std::pow(2.0, cents / 1200.0);
+		return true;
+	}
+	double num = std::strtod(token.c_str(), &end);
+	double den = 1.0;
+	if (*end == '/') {
+		den = std::strtod(end + 1, &end);
+	}
+	if (*end != '\0' || !(num > 0.0) || !(den > 0.0))
+		return false;
+	ratio = num / den;
+	return true;
+}
+
+static bool parseInt(const std::string& line, int& value) {
+	std::string token = firstToken(line);
+	char* end;
+	long v = std::strtol(token.c_str(), &end, 10);
+	if (token.empty() || *end != '\0')
+		return false;
+	value = (int)v;
+	return true;
+}
+
+static int floorDiv(int a, int b) {
+	int q = a / b;
+	if ((a % b != 0) && ((a < 0) != (b < 0)))
+		q--;
+	return q;
+}
+
+
+bool parseScalaScale(const std::string& text, ScalaScale& scale, std::string& error) {
+	std::vector<std::string> lines = scalaLines(text);
+	if (lines.size() < 2) {
+		error = "Missing description or note count";
+		return false;
+	}
+	// The description line may be empty, so it is taken verbatim
+	scale.description = lines[0];
+	scale.ratios.clear();
+
+	size_t i = 1;
+	while (i < lines.size() && firstToken(lines[i]).empty())
+		i++;
+	int count;
+	if (i >= lines.size() || !parseInt(lines[i], count) || count < 1) {
+		error = "Invalid note count";
+		return false;
+	}
+	for (i++; i < lines.size() && (int)scale.ratios.size() < count; i++) {
+		std::string token = firstToken(lines[i]);
+		if (token.empty())
+			continue;
+		double ratio;
+		if (!parsePitch(token, ratio)) {
+			error = "Invalid pitch \"" + token + "\"";
+			return false;
+		}
+		scale.ratios.push_back(ratio);
+	}
+	if ((int)scale.ratios.size() != count) {
+		error = "Expected " + std::to_string(count) + " pitches, found " + std::to_string(scale.ratios.size());
+		return false;
+	}
+	return true;
+}
+
+
+bool parseScalaMapping(const std::string& text, ScalaMapping& mapping, std::string& error) {
+	std::vector<std::string> lines;
+	for (const std::string& line : scalaLines(text)) {
+		if (!firstToken(line).empty())
+			lines.push_back(line);
+	}
+	if (lines.size() < 7) {
+		error = "Missing keyboard mapping header";
+		return false;
+	}
+
+	// Header: map size, first note, last note, middle note, reference note,
+	// reference frequency, formal octave degree
+	// The retuning range (first/last note) is not used: V/Oct has no key range,
+	// so every key in the table is retuned
+	int firstNote, lastNote;
+	char* end;
+	if (!parseInt(lines[0], mapping.size) || mapping.size < 0
+	    || !parseInt(lines[1], firstNote) || !parseInt(lines[2], lastNote)
+	    || !parseInt(lines[3], mapping.middleNote) || !parseInt(lines[4], mapping.referenceNote)) {
+		error = "Invalid keyboard mapping header";
+		return false;
+	}
+	std::string freqToken = firstToken(lines[5]);
+	mapping.referenceFreq = std::strtod(freqToken.c_str(), &end);
+	if (*end != '\0' || !(mapping.referenceFreq > 0.0)) {
+		error = "Invalid reference frequency";
+		return false;
+	}
+	if (!parseInt(lines[6], mapping.octaveDegree) || mapping.octaveDegree < 0) {
+		error = "Invalid formal octave degree";
+		return false;
+	}
+
+	// Missing entries at the end of the map are unmapped
+	mapping.keys.assign(mapping.size, -1);
+	for (int k = 0; k < mapping.size && 7 + k < (int)lines.size(); k++) {
+		std::string token = firstToken(lines[7 + k]);
+		if (token == "x" || token == "X")
+			continue;
+		if (!parseInt(token, mapping.keys[k]) || mapping.keys[k] < 0) {
+			error = "Invalid mapping entry \"" + token + "\"";
+			return false;
+		}
+	}
+	return true;
+}
+
+
+// Frequency ratio of any scale degree, including negative and multi-period degrees
+static double degreeRatio(const ScalaScale& scale, int degree) {
+	int n = (int)scale.ratios.size();
+	int period = floorDiv(degree, n);
+	int step = degree - period * n;
+	double ratio = (step == 0) ? 1.0 : scale.ratios[step - 1];
+	return std::pow(scale.ratios.back(), period) * ratio;
+}
+
+// Scale degree of a MIDI key, false if the key is unmapped
+static bool keyDegree(const ScalaScale& scale, const ScalaMapping& mapping, int key, int& degree) {
+	int offset = key - mapping.middleNote;
+	if (mapping.size == 0) {
+		degree = offset;
+		return true;
+	}
+	int period = floorDiv(offset, mapping.size);
+	int mapped = mapping.keys[offset - period * mapping.size];
+	if (mapped < 0)
+		return false;
+	int octaveDegree = (mapping.octaveDegree > 0) ? mapping.octaveDegree : (int)scale.ratios.size();
+	degree = period * octaveDegree + mapped;
+	return true;
+}
+
+
+void FrequencyTable::build12Tet() {
+	for (int i = 0; i <= SIZE; i++) {
+		double volts = (double)i / STEPS_PER_VOLT + MIN_VOLTS;
+		freq[i] = (float)(dsp::FREQ_C4 * std::pow(2.0, volts));
+	}
+}
+
+
+bool FrequencyTable::build(const ScalaScale& scale, const ScalaMapping& mapping) {
+	if (scale.ratios.empty())
+		return false;
+
+	int refDegree;
+	if (!keyDegree(scale, mapping, mapping.referenceNote, refDegree))
+		return false;
+	double refRatio = degreeRatio(scale, refDegree);
+
+	// One frequency per key across the table range (0V = MIDI 60)
+	const int minKey = 60 + MIN_VOLTS * 12;
+	const int numKeys = (MAX_VOLTS - MIN_VOLTS) * 12 + 1;
+	std::vector<double> keyFreq(numKeys, 0.0);
+	for (int k = 0; k < numKeys; k++) {
+		int degree;
+		if (keyDegree(scale, mapping, minKey + k, degree))
+			keyFreq[k] = mapping.referenceFreq * degreeRatio(scale, degree) / refRatio;
+	}
+
+	// Fill unmapped keys geometrically between mapped neighbours, and with
+	// 12-TET semitones beyond the outermost mapped keys
+	const double semitone = std::pow(2.0, 1.0 / 12.0);
+	int prev = -1;
+	for (int k = 0; k < numKeys; k++) {
+		if (keyFreq[k] <= 0.0)
+			continue;
+		if (prev < 0) {
+			for (int j = k - 1; j >= 0; j--)
+				keyFreq[j] = keyFreq[j + 1] / semitone;
+		}
+		else if (k - prev > 1) {
+			double step = std::pow(keyFreq[k] / keyFreq[prev], 1.0 / (k - prev));
+			for (int j = prev + 1; j < k; j++)
+				keyFreq[j] = keyFreq[j - 1] * step;
+		}
+		prev = k;
+	}
+	if (prev < 0)
+		return false;
+	for (int j = prev + 1; j < numKeys; j++)
+		keyFreq[j] = keyFreq[j - 1] * semitone;
+
+	for (int k = 0; k < numKeys; k++) {
+		if (!std::isfinite(keyFreq[k]) || !(keyFreq[k] > 0.0))
+			return false;
+	}
+
+	// Geometric steps within each key so interpolation follows the pitch curve
+	for (int k = 0; k < numKeys - 1; k++) {
+		double ratio = keyFreq[k + 1] / keyFreq[k];
+		for (int s = 0; s < STEPS_PER_KEY; s++) {
+			freq[k * STEPS_PER_KEY + s] = (float)(keyFreq[k] * std::pow(ratio, (double)s / STEPS_PER_KEY));
+		}
+	}
+	freq[SIZE] = (float)keyFreq[numKeys - 1];
+	return true;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "plugin.hpp"
+
+using simd::float_4;
+
+// Scala scale (.scl)
+// Degrees are stored as frequency ratios relative to the tonic (degree 0 = 1/1
+// is implicit). The last degree is the period the scale repeats at, usually 2/1.
+struct ScalaScale {
+	std::string description;
+	std::vector<double> ratios;
+};
+
+// Scala keyboard mapping (.kbm)
+// Defaults map the scale linearly with the tonic on MIDI note 60, which is
+// 0V (C4) on the V/Oct input, tuned to dsp::FREQ_C4.
+struct ScalaMapping {
+	int size = 0;  // 0 = linear mapping (every key is the next degree)
+	int firstNote = 0;
+	int lastNote = 127;
+	int middleNote = 60;
+	int referenceNote = 60;
+	double referenceFreq = dsp::FREQ_C4;
+	int octaveDegree = 0;  // Degree the mapping repeats at (0 = scale size)
+	std::vector<int> keys;  // Scale degree per map position, -1 = unmapped
+};
+
+// Parsers return false and set `error` on malformed input
+bool parseScalaScale(const std::string& text, ScalaScale& scale, std::string& error);
+bool parseScalaMapping(const std::string& text, ScalaMapping& mapping, std::string& error);
+
+// Interpolated V/Oct -> frequency lookup
+// Keys are 1/12 V apart (0V = C4 = MIDI 60) and each key interval is split
+// into STEPS_PER_KEY geometric steps, so linear interpolation between entries
+// stays within ~0.01 cent. Pitch offsets are folded into the table index
+// once per frame (indexOffset). The range reaches below the 0.1 Hz oscillator
+// clamp and above Nyquist at 768 kHz, so clamping the index never changes
+// the clamped frequency. The lookup is not cheaper than dsp::exp2_taylor5
+// (about 1.5x its cost per float_4, from the scalar gathers); it is what
+// makes arbitrary tunings possible.
+struct FrequencyTable {
+	static constexpr int STEPS_PER_KEY = 16;
+	static constexpr int STEPS_PER_VOLT = 12 * STEPS_PER_KEY;
+	static constexpr int MIN_VOLTS = -12;  // 0.064 Hz
+	static constexpr int MAX_VOLTS = 11;   // 535 kHz
+	static constexpr int SIZE = (MAX_VOLTS - MIN_VOLTS) * STEPS_PER_VOLT;
+
+	float freq[SIZE + 1];
+
+	// Exact 12-TET (matches dsp::FREQ_C4 * 2^pitch)
+	void build12Tet();
+	// Returns false if the scale/mapping produce non-positive frequencies
+	bool build(const ScalaScale& scale, const ScalaMapping& mapping);
+
+	// Table index of a control-rate pitch offset in V/Oct
+	static float indexOffset(float volts) {
+		return (volts - MIN_VOLTS) * STEPS_PER_VOLT;
+	}
+
+	// tables: one per voice (voices of several modules can share a SIMD group)
+	// pitch: per-voice V/Oct, offset: from indexOffset()
+	static float_4 lookup(const FrequencyTable* const* tables, float_4 pitch, float_4 offset) {
+		float_4 index = simd::clamp(pitch * (float)STEPS_PER_VOLT + offset, 0.f, (float)(SIZE - 1));
+		float_4 base = simd::floor(index);
+		float_4 frac = index - base;
+		float_4 f0, f1;
+		for (int i = 0; i < 4; i++) {
+			int j = (int)base[i];
+			f0[i] = tables[i]->freq[j];
+			f1[i] = tables[i]->freq[j + 1];
+		}
+		return f0 + (f1 - f0) * frac;
+	}
+};
@@ -0,0 +1,844 @@
+#pragma once
+#include "plugin.hpp"
+#include "LatencyProfiler.hpp"
+#include "MinBlepTables.hpp"
+#include "Tuning.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// Oscillator core: everything that renders voices from FrameControls, with no
+// dependency on the engine, ports or UI. The module, the BatchEngine and the
+// offline quality tests (tests/) all render through VoiceBank.
+
+using simd::float_4;
+
+// MinBLEP kernels are generated at build time (MinBlepTables.hpp), so there is
+// no table construction at plugin load. MINBLEP_KERNELS is ordered by quality.
+static constexpr int MINBLEP_DEFAULT_QUALITY = MINBLEP_KERNEL_COUNT - 1;
+
+// SIMD-compatible MinBLEP buffer with stride support
+// Stores 4 interleaved lanes for efficient SIMD processing
+template <int N>
+struct MinBlepBuffer {
+	static_assert(N >= MINBLEP_MAX_Z, "Buffer too short for the longest MinBLEP kernel");
+
+	float_4 buffer[2 * N] = {};
+	int pos = 0;
+
+	// Insert discontinuity with stride=4 for a single lane
+	// kernel: MinBLEP table to use (length 2 * kernel.z samples)
+	// p: subsample position (-1 < p <= 0)
+	// x: discontinuity magnitude
+	// lane: which SIMD lane (0-3)
+	void insertDiscontinuity(const MinBlepKernel& kernel, float p, float x, int lane) {
+		if (!(-1.f < p && p <= 0.f))
+			return;
+		// Blend the two table phases either side of the subsample position
+		float t = -p * kernel.o;
+		int phase = std::min((int)t, kernel.o - 1);
+		float frac = t - phase;
+		const float* row0 = kernel.table + phase * 2 * kernel.z;
+		const float* row1 = row0 + 2 * kernel.z;
+		for (int j = 0; j < 2 * kernel.z; j++) {
+			int index = (pos + j) % (2 * N);
+			// Access specific lane using array indexing
+			buffer[index][lane] += x * (row0[j] + (row1[j] - row0[j]) * frac);
+		}
+	}
+
+	float_4 process() {
+		float_4 v = buffer[pos];
+		buffer[pos] = float_4(0.f);
+		pos = (pos + 1) % (2 * N);
+		return v;
+	}
+
+	// Drop pending corrections for one lane (voice handed to a new owner)
+	void clearLane(int lane) {
+		for (int j = 0; j < 2 * N; j++)
+			buffer[j][lane] = 0.f;
+	}
+
+	int countSubnormals() const {
+		return ::countSubnormals(reinterpret_cast<const float*>(buffer), 2 * N * 4);
+	}
+};
+
+// VcoEngine: Reusable oscillator DSP with SIMD state
+// Encapsulates all per-oscillator state for dual VCO architecture
+struct VcoEngine {
+	float_4 phase[4] = {};
+	float_4 oldPhase[4] = {};
+	float_4 deltaPhase[4] = {};
+	MinBlepBuffer<32> sawMinBlepBuffer[4];
+	MinBlepBuffer<32> sqrMinBlepBuffer[4];
+	MinBlepBuffer<32> triMinBlepBuffer[4];
+	MinBlepBuffer<32> xorMinBlepBuffer[4];  // XOR discontinuity tracking
+	const MinBlepKernel* minBlep[16];  // Per voice
+
+	// Edge scheduling: number of upcoming samples in which no lane of the group
+	// can wrap or cross its PWM threshold (0 = unknown, run full edge detection)
+	// Predicted with a frequency bound EDGE_DELTA_TOLERANCE above the current
+	// rate and a PWM band of +/-EDGE_PWM_TOLERANCE; leaving either invalidates it
+	static constexpr float EDGE_DELTA_TOLERANCE = 0.01f;
+	static constexpr float EDGE_PWM_TOLERANCE = 0.01f;
+	// Largest rounding error of one `phase += deltaPhase` below 1 (half an ulp
+	// of 1.f). Near the 0.1 Hz clamp at high sample rates it is larger than
+	// EDGE_DELTA_TOLERANCE, so it is added to every predicted step.
+	static constexpr float PHASE_ROUNDING = 0.5f * FLT_EPSILON;
+	static constexpr int MAX_EDGE_COUNTDOWN = 1 << 16;
+	// Samples to wait before predicting again after an invalidation, so
+	// continuously modulated groups (audio-rate FM) don't pay for prediction
+	static constexpr int EDGE_BACKOFF = 32;
+	int edgeCountdown[4] = {};
+	int edgeBackoff[4] = {};
+	float_4 edgeDeltaBound[4] = {};
+	float_4 edgePwm[4] = {};
+
+	VcoEngine() {
+		std::fill(minBlep, minBlep + 16, &MINBLEP_KERNELS[MINBLEP_DEFAULT_QUALITY]);
+	}
+
+	// Process one SIMD group (4 voices), returns 4 waveforms via output parameters
+	// g: SIMD group index (0-3)
+	// freq: frequency for 4 voices
+	// sampleTime: 1/sampleRate
+	// pwm: pulse width for 4 voices
+	// wrapMask: output parameter indicating which lanes wrapped
+	// fallMask: output parameter indicating which lanes crossed the PWM threshold
+	// sqr1Input: square wave from VCO1 (for XOR calculation in VCO2)
+	// xorOut: optional XOR output pointer
+	void process(int g, float_4 freq, float sampleTime, float_4 pwm,
+	             float_4& saw, float_4& sqr, float_4& tri, float_4& sine,
+	             int& wrapMask, int& fallMask,
+	             float_4 sqr1Input = float_4(0.f),  // Square from VCO1 (for XOR)
+	             float_4* xorOut = nullptr) {        // Optional XOR output
+		// Phase accumulation with SIMD
+		deltaPhase[g] = simd::clamp(freq * sampleTime, 0.f, 0.49f);
+		oldPhase[g] = phase[g];
+		phase[g] += deltaPhase[g];
+
+		// Fast path: the scheduler guarantees no wrap or PWM crossing in any
+		// lane this sample, so phase stays below 1 and there are no edges
+		wrapMask = 0;
+		fallMask = 0;
+		if (!consumeEdgeFreeSample(g, pwm)) {
+			// Detect phase wrap
+			float_4 wrapped = phase[g] >= 1.f;
+			phase[g] -= simd::floor(phase[g]);  // Handles large FM jumps
+			wrapMask = simd::movemask(wrapped);
+
+			// Falling edge detection (phase crosses PWM threshold)
+			float_4 fallingEdge = (oldPhase[g] < pwm) & (phase[g] >= pwm);
+			fallMask = simd::movemask(fallingEdge);
+
+			scheduleEdges(g, pwm);
+		}
+
+		// === SAWTOOTH with strided MinBLEP ===
+		if (wrapMask) {
+			for (int i = 0; i < 4; i++) {
+				if ((wrapMask & (1 << i)) && deltaPhase[g][i] > 0.f) {
+					float subsample = (1.f - oldPhase[g][i]) / deltaPhase[g][i] - 1.f;
+					sawMinBlepBuffer[g].insertDiscontinuity(*minBlep[g * 4 + i], subsample, -2.f, i);
+				}
+			}
+		}
+		saw = 2.f * phase[g] - 1.f + sawMinBlepBuffer[g].process();
+
+		// === SQUARE with PWM using strided MinBLEP ===
+		if (fallMask) {
+			for (int i = 0; i < 4; i++) {
+				if ((fallMask & (1 << i)) && deltaPhase[g][i] > 0.f) {
+					float subsample = (pwm[i] - oldPhase[g][i]) / deltaPhase[g][i] - 1.f;
+					sqrMinBlepBuffer[g].insertDiscontinuity(*minBlep[g * 4 + i], subsample, -2.f, i);
+				}
+			}
+		}
+
+		// Rising edge on wrap
+		if (wrapMask) {
+			for (int i = 0; i < 4; i++) {
+				if ((wrapMask & (1 << i)) && deltaPhase[g][i] > 0.f) {
+					float subsample = (1.f - oldPhase[g][i]) / deltaPhase[g][i] - 1.f;
+					sqrMinBlepBuffer[g].insertDiscontinuity(*minBlep[g * 4 + i], subsample, 2.f, i);
+				}
+			}
+		}
+
+		sqr = simd::ifelse(phase[g] < pwm, 1.f, -1.f) + sqrMinBlepBuffer[g].process();
+
+		// === XOR ring modulation (only if requested) ===
+		if (xorOut != nullptr) {
+			// Raw ring modulation: sqr1 * sqr2
+			*xorOut = sqr1Input * sqr;
+
+			// Track XOR edges from THIS oscillator's square transitions
+			// (sqr1Input edges are tracked separately in VCO1's call)
+
+			// Falling edge detection (PWM threshold crossing)
+			// When sqr transitions from +1 to -1, XOR changes by -2 * sqr1Input
+			if (fallMask) {
+				for (int i = 0; i < 4; i++) {
+					if ((fallMask & (1 << i)) && deltaPhase[g][i] > 0.f) {
+						float subsample = (pwm[i] - oldPhase[g][i]) / deltaPhase[g][i] - 1.f;
+						float xorDisc = -2.f * sqr1Input[i];  // sqr: +1 -> -1
+						xorMinBlepBuffer[g].insertDiscontinuity(*minBlep[g * 4 + i], subsample, xorDisc, i);
+					}
+				}
+			}
+
+			// Rising edge on wrap (when phase wraps, sqr goes from -1 to +1)
+			if (wrapMask) {
+				for (int i = 0; i < 4; i++) {
+					if ((wrapMask & (1 << i)) && deltaPhase[g][i] > 0.f) {
+						float subsample = (1.f - oldPhase[g][i]) / deltaPhase[g][i] - 1.f;
+						float xorDisc = 2.f * sqr1Input[i];  // sqr: -1 -> +1
+						xorMinBlepBuffer[g].insertDiscontinuity(*minBlep[g * 4 + i], subsample, xorDisc, i);
+					}
+				}
+			}
+
+			// Apply MinBLEP correction
+			*xorOut += xorMinBlepBuffer[g].process();
+		}
+
+		// === TRIANGLE via direct calculation (normalized to ±1) ===
+		// Triangle from phase: rises 0->0.5, falls 0.5->1
+		tri = simd::ifelse(phase[g] < 0.5f,
+			4.f * phase[g] - 1.f,           // -1 to +1 as phase goes 0 to 0.5
+			3.f - 4.f * phase[g]);          // +1 to -1 as phase goes 0.5 to 1
+		tri = tri + triMinBlepBuffer[g].process();
+
+		// === SINE (no antialiasing needed) ===
+		sine = simd::sin(2.f * float(M_PI) * phase[g]);
+	}
+
+	// Returns true (and counts down) if this sample is inside the predicted
+	// edge-free horizon and frequency/PWM are still within tolerance
+	bool consumeEdgeFreeSample(int g, float_4 pwm) {
+		if (edgeCountdown[g] <= 0)
+			return false;
+		float_4 drift = (deltaPhase[g] > edgeDeltaBound[g]) | (simd::fabs(pwm - edgePwm[g]) > EDGE_PWM_TOLERANCE);
+		if (simd::movemask(drift)) {
+			edgeCountdown[g] = 0;
+			edgeBackoff[g] = EDGE_BACKOFF;
+			return false;
+		}
+		edgeCountdown[g]--;
+		return true;
+	}
+
+	// Predict how many upcoming samples are edge-free for every lane
+	// Called after edge detection, with phase already wrapped
+	void scheduleEdges(int g, float_4 pwm) {
+		if (edgeBackoff[g] > 0) {
+			edgeBackoff[g]--;
+			return;
+		}
+		float_4 bound = deltaPhase[g] * (1.f + EDGE_DELTA_TOLERANCE);
+		float_4 step = bound + PHASE_ROUNDING;
+		float countdown = (float)MAX_EDGE_COUNTDOWN;
+		for (int i = 0; i < 4; i++) {
+			// A stalled lane never reaches an edge; any rise breaks the bound
+			if (bound[i] <= 0.f)
+				continue;
+			float p = phase[g][i];
+			float target = 1.f;  // Next wrap
+			if (p < pwm[i] - EDGE_PWM_TOLERANCE) {
+				target = pwm[i] - EDGE_PWM_TOLERANCE;  // Falling edge comes first
+			}
+			else if (p < pwm[i] + EDGE_PWM_TOLERANCE) {
+				// Inside the PWM band: a small PWM change could cross the phase
+				countdown = 0.f;
+				break;
+			}
+			// One sample of margin for rounding in the countdown itself
+			countdown = std::min(countdown, (target - p) / step[i] - 1.f);
+		}
+		edgeCountdown[g] = std::max((int)countdown, 0);
+		edgeDeltaBound[g] = bound;
+		edgePwm[g] = pwm;
+	}
+
+	// Phase was moved externally (sync): predictions no longer hold
+	void invalidateEdges(int g) {
+		edgeCountdown[g] = 0;
+	}
+
+	// Return one voice to power-on state (batched rendering lane reuse)
+	void resetLane(int g, int i) {
+		phase[g][i] = 0.f;
+		oldPhase[g][i] = 0.f;
+		deltaPhase[g][i] = 0.f;
+		sawMinBlepBuffer[g].clearLane(i);
+		sqrMinBlepBuffer[g].clearLane(i);
+		triMinBlepBuffer[g].clearLane(i);
+		xorMinBlepBuffer[g].clearLane(i);
+		invalidateEdges(g);
+	}
+
+	// Apply hard sync: reset phase and insert MinBLEP discontinuities
+	// Called after process() when primary oscillator wraps
+	void applySync(int g, int syncMask, float_4 primaryOldPhase, float_4 primaryDeltaPhase, float_4 pwm,
+	               float_4& saw, float_4& sqr, float_4& tri) {
+		invalidateEdges(g);
+		for (int i = 0; i < 4; i++) {
+			if (!(syncMask & (1 << i))) continue;
+			if (deltaPhase[g][i] <= 0.f) continue;  // Skip if negative freq (FM)
+			if (primaryDeltaPhase[i] <= 0.f) continue;  // Skip if primary freq negative
+
+			// Calculate subsample position of primary wrap
+			float subsample = (1.f - primaryOldPhase[i]) / primaryDeltaPhase[i] - 1.f;
+			subsample = clamp(subsample, -1.f + 1e-6f, 0.f);  // Ensure valid range
+
+			// Calculate old waveform values (at current phase, before reset)
+			float currentPhase = phase[g][i];
+			float oldSaw = 2.f * currentPhase - 1.f;
+			float oldSqr = (currentPhase < pwm[i]) ? 1.f : -1.f;
+			float oldTri = (currentPhase < 0.5f)
+				? (4.f * currentPhase - 1.f)
+				: (3.f - 4.f * currentPhase);
+
+			// Reset phase to subsample-accurate position
+			float newPhase = deltaPhase[g][i] * (-subsample);
+			phase[g][i] = newPhase;
+
+			// Calculate new waveform values (at reset phase)
+			float newSaw = 2.f * newPhase - 1.f;
+			float newSqr = (newPhase < pwm[i]) ? 1.f : -1.f;
+			float newTri = (newPhase < 0.5f)
+				? (4.f * newPhase - 1.f)
+				: (3.f - 4.f * newPhase);
+
+			// Insert MinBLEP discontinuities for all geometric waveforms
+			sawMinBlepBuffer[g].insertDiscontinuity(*minBlep[g * 4 + i], subsample, newSaw - oldSaw, i);
+
+			// Square: only insert if value actually changed
+			if (oldSqr != newSqr) {
+				sqrMinBlepBuffer[g].insertDiscontinuity(*minBlep[g * 4 + i], subsample, newSqr - oldSqr, i);
+			}
+
+			// Triangle: uses dedicated triMinBlepBuffer (added in Task 1)
+			// Insert amplitude discontinuity for sync-induced phase reset
+			triMinBlepBuffer[g].insertDiscontinuity(*minBlep[g * 4 + i], subsample, newTri - oldTri, i);
+
+			// Update waveform output values for this lane to reflect synced phase
+			saw[i] = newSaw;
+			sqr[i] = newSqr;
+			tri[i] = newTri;
+		}
+	}
+
+	// Subnormal values in phase state and MinBLEP rings (latency profiler)
+	int countSubnormals() const {
+		int count = ::countSubnormals(reinterpret_cast<const float*>(phase), 4 * 4)
+		          + ::countSubnormals(reinterpret_cast<const float*>(oldPhase), 4 * 4)
+		          + ::countSubnormals(reinterpret_cast<const float*>(deltaPhase), 4 * 4);
+		for (int g = 0; g < 4; g++) {
+			count += sawMinBlepBuffer[g].countSubnormals();
+			count += sqrMinBlepBuffer[g].countSubnormals();
+			count += triMinBlepBuffer[g].countSubnormals();
+			count += xorMinBlepBuffer[g].countSubnormals();
+		}
+		return count;
+	}
+};
+
+// Per-voice vibrato LFO bank (4 SIMD groups x 4 voices)
+// Each voice is a recursive quadrature oscillator: once per control tick the
+// (sin, cos) pair is rotated by the voice's phase increment, so there is no
+// transcendental function per sample. The output is linearly interpolated
+// between ticks.
+// Spread > 0 gives each voice a random rate offset and a random starting phase
+// at every gate onset; spread = 0 keeps all voices in free-running unison.
+struct VibratoLfoBank {
+	static constexpr int CONTROL_DIVISION = 16;  // Samples per control tick
+	static constexpr float MAX_RATE_SPREAD = 0.15f;  // +/-15% rate at full spread
+
+	float_4 sinState[4];
+	float_4 cosState[4];
+	float_4 rateJitter[4];  // -1 to 1 per voice, scaled by spread
+	float_4 envelope[4];    // Delay fade-in, 0-1
+	float_4 gateHigh[4];    // Previous gate state (mask)
+	float_4 value[4];       // Interpolated output, -1 to 1
+	float_4 step[4];        // Per-sample increment towards the next tick
+	// Control clock and generator (xorshift32) per voice, so a voice renders
+	// the same whichever bank lane it occupies and a captured input stream
+	// replays bit-exactly
+	int counter[16];
+	uint32_t rngState[16];
+
+	VibratoLfoBank() {
+		reset();
+	}
+
+	void reset() {
+		for (int lane = 0; lane < 16; lane++)
+			resetLane(lane / 4, lane % 4, lane);
+	}
+
+	// Power-on state for one lane; voice seeds its generator
+	void resetLane(int g, int i, int voice) {
+		int lane = g * 4 + i;
+		counter[lane] = 0;
+		rngState[lane] = 0x9e3779b9u * (uint32_t)(voice + 1);
+		sinState[g][i] = 0.f;
+		cosState[g][i] = 1.f;
+		rateJitter[g][i] = 2.f * uniform(lane) - 1.f;
+		envelope[g][i] = 1.f;
+		gateHigh[g][i] = 0.f;
+		value[g][i] = 0.f;
+		step[g][i] = 0.f;
+	}
+
+	float uniform(int lane) {
+		uint32_t& state = rngState[lane];
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return (state >> 8) * (1.f / 16777216.f);
+	}
+
+	// Advance one group's control clocks by a sample; lane mask of voices
+	// that reach a control tick
+	int clock(int g) {
+		int tickMask = 0;
+		for (int i = 0; i < 4; i++) {
+			int& count = counter[g * 4 + i];
+			if (++count >= CONTROL_DIVISION) {
+				count = 0;
+				tickMask |= 1 << i;
+			}
+		}
+		return tickMask;
+	}
+
+	// Control-rate update for the voices in tickMask (all controls are per voice)
+	// gate: gate voltages, gateConnected: 0 disables the delay, 1 enables it
+	// rate: Hz, delay: fade-in seconds after gate onset, spread: 0-1
+	// sampleTime: engine sample time (one tick = CONTROL_DIVISION samples)
+	void tick(int g, int tickMask, float_4 gate, float_4 gateConnected, float_4 rate, float_4 delay, float_4 spread, float sampleTime) {
+		float tickTime = sampleTime * CONTROL_DIVISION;
+		float_4 ticking = simd::movemaskInverse<float_4>(tickMask);
+
+		float_4 connected = gateConnected > 0.f;
+		float_4 high = gate >= 1.f;
+		int onsetMask = simd::movemask(high & ~gateHigh[g] & connected & ticking);
+		gateHigh[g] = simd::ifelse(connected & ticking, high, gateHigh[g]);
+		if (onsetMask) {
+			for (int i = 0; i < 4; i++) {
+				if (!(onsetMask & (1 << i)))
+					continue;
+				envelope[g][i] = 0.f;
+				if (spread[i] > 0.f) {
+					// New random phase (within the spread) and rate offset per note
+					int lane = g * 4 + i;
+					float theta = 2.f * float(M_PI) * spread[i] * uniform(lane);
+					sinState[g][i] = std::sin(theta);
+					cosState[g][i] = std::cos(theta);
+					rateJitter[g][i] = 2.f * uniform(lane) - 1.f;
+				}
+			}
+		}
+		float_4 fade = simd::ifelse(delay > 0.f, simd::fmin(envelope[g] + tickTime / delay, 1.f), 1.f);
+		envelope[g] = simd::ifelse(ticking, simd::ifelse(connected, fade, 1.f), envelope[g]);
+
+		// Rotation angle per tick is small (< 0.03 rad), so a short Taylor
+		// series for sin/cos is exact to float precision
+		float_4 omega = 2.f * float(M_PI) * rate * tickTime * (1.f + MAX_RATE_SPREAD * spread * rateJitter[g]);
+		float_4 omega2 = omega * omega;
+		float_4 rotSin = omega * (1.f - omega2 * (1.f / 6.f));
+		float_4 rotCos = 1.f - omega2 * (0.5f - omega2 * (1.f / 24.f));
+
+		float_4 s = sinState[g] * rotCos + cosState[g] * rotSin;
+		float_4 c = cosState[g] * rotCos - sinState[g] * rotSin;
+		// First-order renormalization keeps the amplitude from drifting
+		float_4 norm = 1.5f - 0.5f * (s * s + c * c);
+		sinState[g] = simd::ifelse(ticking, s * norm, sinState[g]);
+		cosState[g] = simd::ifelse(ticking, c * norm, cosState[g]);
+
+		float_4 target = sinState[g] * envelope[g];
+		step[g] = simd::ifelse(ticking, (target - value[g]) * (1.f / CONTROL_DIVISION), step[g]);
+	}
+
+	// Per-sample interpolated output for one group
+	float_4 process(int g) {
+		value[g] += step[g];
+		return value[g];
+	}
+};
+
+// Control values sampled once per rendered frame
+// (every sample, or once per block in block-rendering mode)
+// Every control is stored per voice, so voices from several modules can share
+// a SIMD group when they are rendered together (BatchEngine).
+struct FrameControls {
+	int channels;
+
+	// Tuning table per voice, and control-rate pitch offsets folded into table indices
+	const FrequencyTable* freqTable[16];
+	// Anti-aliasing kernel per voice
+	const MinBlepKernel* minBlep[16];
+	float_4 pitchOffset1[4], pitchOffset2[4], subPitchOffset[4];
+
+	// Scalar waveform volumes (no CV per Context decision)
+	float_4 triVol1[4], sinVol1[4], triVol2[4], sinVol2[4];
+
+	float_4 subWave[4];        // 0 = square, 1 = sine
+	int fmSource[4];           // 0=Sin, 1=Tri, 2=Saw, 3=Sqr, 4=Sub, -1 = differs per voice
+	float_4 fmSourceLanes[4];  // Per voice, used when fmSource is -1
+	int sync1Hard[4], sync1Soft[4], sync2Hard[4], sync2Soft[4];  // Lane masks
+	float_4 vibrato1Depth[4], vibrato2Depth[4];
+	float_4 vibratoRate[4], vibratoDelay[4], vibratoSpread[4];
+	float_4 gateConnected[4];  // 0 or 1
+
+	// Per SIMD group (4 voices)
+	float_4 basePitch[4];
+	float_4 pwm1[4], pwm2[4];
+	float_4 saw1Vol[4], sqr1Vol[4], subVol[4], xorVol[4], sqr2Vol[4], saw2Vol[4];
+	float_4 fmDepth[4];
+	float_4 gate[4];
+
+	// Calls f(field) for each control with one value per voice (one call per
+	// field rather than a table, so copyLane() unrolls)
+	typedef float_4 (FrameControls::*VoiceField)[4];
+	template <typename F>
+	static void forEachVoiceField(F f) {
+		f(&FrameControls::pitchOffset1); f(&FrameControls::pitchOffset2); f(&FrameControls::subPitchOffset);
+		f(&FrameControls::triVol1); f(&FrameControls::sinVol1); f(&FrameControls::triVol2); f(&FrameControls::sinVol2);
+		f(&FrameControls::subWave); f(&FrameControls::fmSourceLanes);
+		f(&FrameControls::vibrato1Depth); f(&FrameControls::vibrato2Depth);
+		f(&FrameControls::vibratoRate); f(&FrameControls::vibratoDelay); f(&FrameControls::vibratoSpread);
+		f(&FrameControls::gateConnected);
+		f(&FrameControls::basePitch); f(&FrameControls::pwm1); f(&FrameControls::pwm2);
+		f(&FrameControls::saw1Vol); f(&FrameControls::sqr1Vol); f(&FrameControls::subVol);
+		f(&FrameControls::xorVol); f(&FrameControls::sqr2Vol); f(&FrameControls::saw2Vol);
+		f(&FrameControls::fmDepth); f(&FrameControls::gate);
+	}
+
+	// Copy every control of voice srcLane in src to voice `lane`
+	void copyLane(int lane, const FrameControls& src, int srcLane) {
+		int g = lane / 4, i = lane % 4;
+		int srcG = srcLane / 4, srcI = srcLane % 4;
+		forEachVoiceField([&](VoiceField field) {
+			(this->*field)[g][i] = (src.*field)[srcG][srcI];
+		});
+
+		freqTable[lane] = src.freqTable[srcLane];
+		minBlep[lane] = src.minBlep[srcLane];
+		int* masks[] = {sync1Hard, sync1Soft, sync2Hard, sync2Soft};
+		const int* srcMasks[] = {src.sync1Hard, src.sync1Soft, src.sync2Hard, src.sync2Soft};
+		for (int m = 0; m < 4; m++) {
+			int bit = (srcMasks[m][srcG] >> srcI) & 1;
+			masks[m][g] = (masks[m][g] & ~(1 << i)) | (bit << i);
+		}
+	}
+
+	// Recompute fmSource after copyLane() (switch per group when voices agree)
+	void updateFmSource(int groups) {
+		for (int g = 0; g < groups; g++) {
+			float_4 lanes = fmSourceLanes[g];
+			bool uniform = (lanes[1] == lanes[0]) && (lanes[2] == lanes[0]) && (lanes[3] == lanes[0]);
+			fmSource[g] = uniform ? (int)lanes[0] : -1;
+		}
+	}
+};
+
+// Rendered voltages for one sample
+struct OutputFrame {
+	float_4 audio[4];
+	float_4 sub[4];
+	// Lane masks per group for the voice activity display
+	int wrap1[4], wrap2[4], sync[4];
+};
+
+// Voice DSP state for up to 16 voices (4 SIMD groups)
+// Each module renders through its own bank; batched modules share the banks
+// of the BatchEngine instead.
+struct VoiceBank {
+	// Dual VCO engines (each encapsulates phase, MinBLEP buffers, tri state)
+	VcoEngine vco1;
+	VcoEngine vco2;
+
+	// XOR MinBLEP tracking for VCO1 square edges (bank-level, not in VcoEngine)
+	MinBlepBuffer<32> xorFromVco1MinBlep[4];  // Track VCO1 sqr transitions for XOR
+
+	// Sub-oscillator state (tracks VCO1 at -1 octave)
+	float_4 subPhase[4] = {};
+
+	// DC filters kept scalar (not in hot path, operate on mixed output)
+	dsp::TRCFilter<float> dcFilters[16];
+
+	// Per-voice vibrato LFOs
+	VibratoLfoBank vibratoLfo;
+
+	void reset() {
+		vco1 = VcoEngine();
+		vco2 = VcoEngine();
+		for (int g = 0; g < 4; g++) {
+			xorFromVco1MinBlep[g] = MinBlepBuffer<32>();
+			subPhase[g] = 0.f;
+		}
+		for (int i = 0; i < 16; i++)
+			dcFilters[i] = dsp::TRCFilter<float>();
+		vibratoLfo.reset();
+	}
+
+	// Return one voice to power-on state, leaving the others untouched
+	// voice: the owner's voice index, which seeds the vibrato generator so the
+	// voice renders the same in any lane
+	void resetLane(int lane, int voice) {
+		int g = lane / 4, i = lane % 4;
+		vco1.resetLane(g, i);
+		vco2.resetLane(g, i);
+		xorFromVco1MinBlep[g].clearLane(i);
+		subPhase[g][i] = 0.f;
+		dcFilters[lane] = dsp::TRCFilter<float>();
+		vibratoLfo.resetLane(g, i, voice);
+	}
+
+	// Subnormal values anywhere in the DSP state (latency profiler report)
+	int countSubnormals() const {
+		int count = vco1.countSubnormals() + vco2.countSubnormals();
+		for (int g = 0; g < 4; g++)
+			count += xorFromVco1MinBlep[g].countSubnormals();
+		count += ::countSubnormals(reinterpret_cast<const float*>(subPhase), 4 * 4);
+		for (int i = 0; i < 16; i++) {
+			count += isSubnormal(dcFilters[i].xstate[0]) + isSubnormal(dcFilters[i].ystate[0]);
+		}
+		return count;
+	}
+
+	// Render one sample for all active voice groups
+	void render(const FrameControls& ctl, float sampleTime, float sampleRate, OutputFrame& frame) {
+		renderBlock(ctl, sampleTime, sampleRate, &frame, 1);
+	}
+
+	// Render count samples from one set of controls. Group-major: each SIMD
+	// group runs the whole block before the next one starts, so its controls
+	// and oscillator state stay in registers and L1 across the block.
+	void renderBlock(const FrameControls& ctl, float sampleTime, float sampleRate, OutputFrame* frames, int count) {
+		int channels = ctl.channels;
+
+		// Fixed output scaling - divide by 3 (typical number of active waveforms)
+		// User controls final level via individual waveform volumes
+		const float outputScale = 1.f / 3.f;
+
+		std::copy(ctl.minBlep, ctl.minBlep + 16, vco1.minBlep);
+		std::copy(ctl.minBlep, ctl.minBlep + 16, vco2.minBlep);
+
+		// Process in SIMD groups of 4 voices
+		for (int c = 0; c < channels; c += 4) {
+			int groupChannels = std::min(channels - c, 4);
+			int g = c / 4;  // SIMD group index
+
+			// Controls are fixed for the block: load them once per group
+			float_4 basePitch = ctl.basePitch[g];
+			float_4 pwm1_4 = ctl.pwm1[g];
+			float_4 pwm2_4 = ctl.pwm2[g];
+			const FrequencyTable* const* freqTables = &ctl.freqTable[c];
+			float_4 pitchOffset1 = ctl.pitchOffset1[g];
+			float_4 pitchOffset2 = ctl.pitchOffset2[g];
+			float_4 gate = ctl.gate[g];
+			float_4 gateConnected = ctl.gateConnected[g];
+			float_4 vibratoRate = ctl.vibratoRate[g];
+			float_4 vibratoDelay = ctl.vibratoDelay[g];
+			float_4 vibratoSpread = ctl.vibratoSpread[g];
+			float_4 subSquareMask = ctl.subWave[g] < 0.5f;
+			int fmSource = ctl.fmSource[g];
+			float_4 fmSourceLanes = ctl.fmSourceLanes[g];
+			float_4 fmDepth = ctl.fmDepth[g];
+			int sync1Hard = ctl.sync1Hard[g], sync1Soft = ctl.sync1Soft[g];
+			int sync2Hard = ctl.sync2Hard[g], sync2Soft = ctl.sync2Soft[g];
+			float_4 triVol1 = ctl.triVol1[g], sqr1Vol = ctl.sqr1Vol[g], sinVol1 = ctl.sinVol1[g], saw1Vol = ctl.saw1Vol[g];
+			float_4 triVol2 = ctl.triVol2[g], sqr2Vol = ctl.sqr2Vol[g], sinVol2 = ctl.sinVol2[g], saw2Vol = ctl.saw2Vol[g];
+			float_4 subVol = ctl.subVol[g], xorVol = ctl.xorVol[g];
+
+			// Vibrato depth in V/Oct (max +/- 0.5 semitone = +/- 1/24 volt)
+			float_4 vibratoScale1 = ctl.vibrato1Depth[g] * (0.5f / 12.f);
+			float_4 vibratoScale2 = ctl.vibrato2Depth[g] * (0.5f / 12.f);
+
+			// Sub-oscillator: -1 octave below VCO1 base, no modulation
+			float_4 subFreq = FrequencyTable::lookup(freqTables, basePitch, ctl.subPitchOffset[g]);
+			subFreq = simd::clamp(subFreq, 1.f, 20000.f);
+			float_4 subDelta = subFreq * sampleTime;
+			float_4 subPhase_4 = subPhase[g];
+
+			for (int i = 0; i < groupChannels; i++)
+				dcFilters[c + i].setCutoffFreq(10.f / sampleRate);
+
+			for (int s = 0; s < count; s++) {
+				OutputFrame& frame = frames[s];
+
+				// Per-voice vibrato (control rate, interpolated per sample)
+				int vibratoTicks = vibratoLfo.clock(g);
+				if (vibratoTicks) {
+					vibratoLfo.tick(g, vibratoTicks, gate, gateConnected,
+					                vibratoRate, vibratoDelay, vibratoSpread, sampleTime);
+				}
+				float_4 vibrato = vibratoLfo.process(g);
+
+				// VCO1: base + octave + detune + vibrato (VCO1 gets detune for thickness)
+				float_4 freq1 = FrequencyTable::lookup(freqTables, basePitch + vibrato * vibratoScale1, pitchOffset1);
+				freq1 = simd::clamp(freq1, 0.1f, sampleRate / 2.f);
+
+				// VCO2: base + octave + fine tune + vibrato
+				float_4 freq2Base = FrequencyTable::lookup(freqTables, basePitch + vibrato * vibratoScale2, pitchOffset2);
+
+				// Phase 1: Process VCO1 first to get waveforms for FM source
+				float_4 saw1, sqr1, tri1, sine1;
+				int vco1WrapMask, vco1FallMask;
+				vco1.process(g, freq1, sampleTime, pwm1_4, saw1, sqr1, tri1, sine1, vco1WrapMask, vco1FallMask);
+
+				// Sub-oscillator (need this early for FM source)
+				subPhase_4 += subDelta;
+				subPhase_4 -= simd::floor(subPhase_4);
+				float_4 subSquare = simd::ifelse(subPhase_4 < 0.5f, 1.f, -1.f);
+				float_4 subSine = simd::sin(2.f * float(M_PI) * subPhase_4);
+				float_4 subOut = simd::ifelse(subSquareMask, subSquare, subSine);
+
+				// Select FM source waveform (0=Sin, 1=Tri, 2=Saw, 3=Sqr, 4=Sub)
+				float_4 fmModulator;
+				switch (fmSource) {
+					case 0: fmModulator = sine1; break;
+					case 1: fmModulator = tri1; break;
+					case 2: fmModulator = saw1; break;
+					case 3: fmModulator = sqr1; break;
+					case 4: fmModulator = subOut; break;
+					default: {
+						// Voices of different modules in one group: select per lane
+						float_4 source = fmSourceLanes;
+						fmModulator = simd::ifelse(source == 1.f, tri1, sine1);
+						fmModulator = simd::ifelse(source == 2.f, saw1, fmModulator);
+						fmModulator = simd::ifelse(source == 3.f, sqr1, fmModulator);
+						fmModulator = simd::ifelse(source == 4.f, subOut, fmModulator);
+					} break;
+				}
+
+				// Through-zero linear FM: selected VCO1 waveform modulates VCO2 frequency
+				// fmModulator is ±1, so freq2 = freq2Base * (1 + fmModulator * fmDepth)
+				float_4 freq2 = freq2Base + freq2Base * fmModulator * fmDepth;
+				freq2 = simd::clamp(freq2, 0.1f, sampleRate / 2.f);
+
+				// Phase 2: Process VCO2 with FM-modulated frequency
+				float_4 saw2, sqr2, tri2, sine2, xorOut;
+				int vco2WrapMask, vco2FallMask;
+				vco2.process(g, freq2, sampleTime, pwm2_4, saw2, sqr2, tri2, sine2, vco2WrapMask, vco2FallMask, sqr1, &xorOut);
+
+				// Track VCO1 square edges for XOR MinBLEP (XOR = sqr1 * sqr2)
+				// When sqr1 transitions, XOR changes by 2 * sqr2
+
+				// VCO1 rising edge (wrap)
+				if (vco1WrapMask) {
+					for (int i = 0; i < 4; i++) {
+						if ((vco1WrapMask & (1 << i)) && vco1.deltaPhase[g][i] > 0.f) {
+							float subsample = (1.f - vco1.oldPhase[g][i]) / vco1.deltaPhase[g][i] - 1.f;
+							// sqr1: -1 -> +1, so XOR changes by 2 * sqr2
+							float xorDisc = 2.f * sqr2[i];
+							xorFromVco1MinBlep[g].insertDiscontinuity(*ctl.minBlep[c + i], subsample, xorDisc, i);
+						}
+					}
+				}
+
+				// VCO1 falling edge (PWM threshold, mask from VCO1's edge detection)
+				if (vco1FallMask) {
+					for (int i = 0; i < 4; i++) {
+						if ((vco1FallMask & (1 << i)) && vco1.deltaPhase[g][i] > 0.f) {
+							float subsample = (pwm1_4[i] - vco1.oldPhase[g][i]) / vco1.deltaPhase[g][i] - 1.f;
+							// sqr1: +1 -> -1, so XOR changes by -2 * sqr2
+							float xorDisc = -2.f * sqr2[i];
+							xorFromVco1MinBlep[g].insertDiscontinuity(*ctl.minBlep[c + i], subsample, xorDisc, i);
+						}
+					}
+				}
+
+				// Combine MinBLEP corrections from both VCO1 and VCO2 edges
+				xorOut += xorFromVco1MinBlep[g].process();
+
+				// Phase 2: Apply sync resets AFTER both VCOs have processed (order matters for bidirectional)
+				// Hard sync: oscillator resets at the start of the other oscillator's cycle
+				// Soft sync: sync amount based on master waveform magnitude
+				int sync1HardMask = sync1Hard & vco2WrapMask;
+				int sync1SoftMask = sync1Soft & vco2WrapMask;
+				int sync2HardMask = sync2Hard & vco1WrapMask;
+				int sync2SoftMask = sync2Soft & vco1WrapMask;
+				if (sync1HardMask) {
+					// VCO1 hard syncs to VCO2: when VCO2 wraps, reset VCO1
+					vco1.applySync(g, sync1HardMask, vco2.oldPhase[g], vco2.deltaPhase[g], pwm1_4,
+					               saw1, sqr1, tri1);
+				}
+				if (sync1SoftMask) {
+					// VCO1 soft syncs to VCO2: sync amount proportional to VCO2 waveform magnitude
+					for (int i = 0; i < 4; i++) {
+						if (sync1SoftMask & (1 << i)) {
+							// Use sine2 magnitude to determine sync strength (0-1)
+							float magnitude = std::abs(sine2[i]);
+							// Blend between current phase and reset phase based on magnitude
+							vco1.phase[g][i] = vco1.phase[g][i] * (1.f - magnitude);
+						}
+					}
+					vco1.invalidateEdges(g);
+				}
+				if (sync2HardMask) {
+					// VCO2 hard syncs to VCO1: when VCO1 wraps, reset VCO2
+					vco2.applySync(g, sync2HardMask, vco1.oldPhase[g], vco1.deltaPhase[g], pwm2_4,
+					               saw2, sqr2, tri2);
+				}
+				if (sync2SoftMask) {
+					// VCO2 soft syncs to VCO1: sync amount proportional to VCO1 waveform magnitude
+					for (int i = 0; i < 4; i++) {
+						if (sync2SoftMask & (1 << i)) {
+							// Use sine1 magnitude to determine sync strength (0-1)
+							float magnitude = std::abs(sine1[i]);
+							// Blend between current phase and reset phase based on magnitude
+							vco2.phase[g][i] = vco2.phase[g][i] * (1.f - magnitude);
+						}
+					}
+					vco2.invalidateEdges(g);
+				}
+
+				frame.wrap1[g] = vco1WrapMask;
+				frame.wrap2[g] = vco2WrapMask;
+				frame.sync[g] = sync1HardMask | sync1SoftMask | sync2HardMask | sync2SoftMask;
+
+				// Output sub to dedicated SUB jack (reduced to ±2V for testing)
+				// Sanitize: subOut is mathematically bounded but defend against upstream NaN
+				float_4 subVoltage = subOut * 2.f;
+				for (int i = 0; i < 4; i++) {
+					if (!std::isfinite(subVoltage[i])) subVoltage[i] = 0.f;
+				}
+				frame.sub[g] = subVoltage;
+
+				// Mix both VCOs with CV-controlled volumes, plus sub-oscillator and XOR
+				// Note: tri and sine still use scalar knob values (no CV per Context decision)
+				float_4 mixed = (tri1 * triVol1 + sqr1 * sqr1Vol + sine1 * sinVol1 + saw1 * saw1Vol
+				              + tri2 * triVol2 + sqr2 * sqr2Vol + sine2 * sinVol2 + saw2 * saw2Vol
+				              + subOut * subVol
+				              + xorOut * xorVol
+				              ) * outputScale;
+
+				// DC filtering and soft clipping - process per-voice
+				for (int i = 0; i < groupChannels; i++) {
+					dcFilters[c + i].process(mixed[i]);
+					float dcFiltered = dcFilters[c + i].highpass();
+
+					// Soft clipping with tanh
+					// Scale factor 3.0: saturates at approximately +/-3V input
+					// This prevents harsh digital clipping when many waveforms sum
+					float softClipped = 3.f * std::tanh(dcFiltered / 3.f);
+
+					// Apply output scaling (+/-2V for testing, +/-5V for production)
+					float out = softClipped * 2.f;
+
+					// Sanitize output: replace NaN/Inf with 0 to prevent propagation
+					mixed[i] = std::isfinite(out) ? out : 0.f;
+				}
+
+				frame.audio[g] = mixed;
+			}
+			subPhase[g] = subPhase_4;
+		}
+	}
+};
@@ -0,0 +1,83 @@
+// Batched rendering benchmark
+// Runs patches of several HydraQuartetVCO instances headless, each once with
+// every module rendering its own voices and once with "Batch with other
+// instances" on, and prints the cost of one engine frame of the whole patch.
+// The modules run on one thread, one after the other, as in an engine with a
+// single thread. The numbers are machine-dependent, so this only reports; it
+// does not fail.
+// Usage: bench_batch [sample rate]
+
+// The module is defined in its own translation unit: include it whole
+#include "HydraQuartetVCO.cpp"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+
+Plugin* pluginInstance = nullptr;
+
+typedef HydraQuartetVCO Vco;
+
+static constexpr int WARMUP_FRAMES = 4800;
+static constexpr int FRAMES = 96000;
+
+struct Patch {
+	int modules;
+	int channels;
+};
+
+// Mean ns per engine frame of the patch
+static double runPatch(const Patch& patch, bool batched, float sampleRate) {
+	std::vector<Vco*> modules;
+	for (int m = 0; m < patch.modules; m++) {
+		Vco* module = new Vco;
+		module->scopeEnabled = false;
+		module->batchEnabled = batched;
+		module->params[Vco::SAW1_PARAM].setValue(3.f);
+		module->params[Vco::SQR2_PARAM].setValue(2.f);
+		module->params[Vco::SUB_LEVEL_PARAM].setValue(1.f);
+		module->params[Vco::FM_PARAM].setValue(0.2f);
+		Vco::overrideInputChannels(module->inputs[Vco::VOCT_INPUT], patch.channels);
+		for (int c = 0; c < patch.channels; c++)
+			module->inputs[Vco::VOCT_INPUT].setVoltage(0.1f * m + c * (1.f / 12.f), c);
+		modules.push_back(module);
+	}
+
+	Module::ProcessArgs args;
+	args.sampleRate = sampleRate;
+	args.sampleTime = 1.f / sampleRate;
+	args.frame = 0;
+	auto runFrames = [&](int frames) {
+		for (int i = 0; i < frames; i++) {
+			for (Vco* module : modules)
+				module->process(args);
+			args.frame++;
+		}
+	};
+	runFrames(WARMUP_FRAMES);
+	auto start = std::chrono::steady_clock::now();
+	runFrames(FRAMES);
+	auto end = std::chrono::steady_clock::now();
+
+	for (Vco* module : modules)
+		delete module;
+	return std::chrono::duration<double, std::nano>(end - start).count() / FRAMES;
+}
+
+int main(int argc, char** argv) {
+	float sampleRate = (argc > 1) ? std::atof(argv[1]) : 48000.f;
+	const Patch patches[] = {
+		{10, 1}, {16, 1}, {32, 1}, {8, 2}, {16, 2}, {8, 3}, {6, 4}, {8, 5}, {6, 6}, {4, 16},
+	};
+
+	std::printf("HydraQuartetVCO batched rendering at %g Hz, ns per engine frame\n", sampleRate);
+	std::printf("%-18s %10s %10s %8s\n", "modules x voices", "own", "batched", "change");
+	for (const Patch& patch : patches) {
+		double own = runPatch(patch, false, sampleRate);
+		double batched = runPatch(patch, true, sampleRate);
+		char name[32];
+		std::snprintf(name, sizeof(name), "%d x %d", patch.modules, patch.channels);
+		std::printf("%-18s %8.0fns %8.0fns %+7.0f%%\n", name, own, batched, 100.0 * (batched / own - 1.0));
+	}
+	return 0;
+}
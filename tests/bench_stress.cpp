@@ -0,0 +1,69 @@
+// Worst-case latency benchmark
+// Drives HydraQuartetVCO::process() outside any engine with the latency
+// profiler on, under each of its stress scenarios, and prints the profiler's
+// report (per-frame p50/p99/p99.9/max and 64-sample block cost). The numbers
+// are machine-dependent, so this only reports; it does not fail.
+// Usage: bench_stress [sample rate]
+
+// The module is defined in its own translation unit: include it whole
+#include "HydraQuartetVCO.cpp"
+#include <cstdio>
+#include <cstdlib>
+
+
+Plugin* pluginInstance = nullptr;
+
+typedef HydraQuartetVCO Vco;
+
+// Report periods to run per scenario; the last one is printed (warm caches)
+static constexpr int REPORT_PERIODS = 3;
+
+int main(int argc, char** argv) {
+	float sampleRate = (argc > 1) ? std::atof(argv[1]) : 48000.f;
+	const char* names[Vco::STRESS_LEN] = {"none (16 voices)", "FM at Nyquist", "hard sync (16 voices)", "PWM sweep", "all"};
+
+	std::printf("HydraQuartetVCO process() latency at %g Hz\n", sampleRate);
+	std::printf("%-22s %8s %8s %8s %8s %8s %12s\n", "scenario", "mean", "p50", "p99", "p99.9", "max", "block p99");
+	for (int scenario = 0; scenario < Vco::STRESS_LEN; scenario++) {
+		Vco* module = new Vco;
+		module->scopeEnabled = false;
+		module->params[Vco::SAW1_PARAM].setValue(3.f);
+		module->params[Vco::SQR1_PARAM].setValue(1.f);
+		module->params[Vco::SQR2_PARAM].setValue(2.f);
+		module->params[Vco::XOR_PARAM].setValue(1.f);
+		module->params[Vco::SUB_LEVEL_PARAM].setValue(1.f);
+		module->params[Vco::FM_PARAM].setValue(0.5f);
+		module->profiler.enabled = true;
+		module->stressScenario = scenario;
+
+		Module::ProcessArgs args;
+		args.sampleRate = sampleRate;
+		args.sampleTime = 1.f / sampleRate;
+		args.frame = 0;
+		LatencyReport report;
+		int reports = 0;
+		while (reports < REPORT_PERIODS) {
+			// Scenarios that leave V/Oct alone get 16 voices from a cable
+			if (scenario == Vco::STRESS_OFF || scenario == Vco::STRESS_HARD_SYNC) {
+				Vco::overrideInputChannels(module->inputs[Vco::VOCT_INPUT], 16);
+				for (int c = 0; c < 16; c++)
+					module->inputs[Vco::VOCT_INPUT].setVoltage(c * (3.f / 16.f), c);
+			}
+			module->process(args);
+			args.frame++;
+			while (const LatencyReport* r = module->profiler.reports.consumerSlot()) {
+				report = *r;
+				module->profiler.reports.consume();
+				reports++;
+			}
+		}
+		std::printf("%-22s %6.0fns %6.0fns %6.0fns %6.0fns %6.0fns %10.0fns\n", names[scenario],
+		            report.meanNs, report.p50Ns, report.p99Ns, report.p999Ns, report.maxNs, report.blockP99Ns);
+		if (report.subnormalOutputs > 0 || report.subnormalState > 0) {
+			std::printf("%-22s %llu subnormal outputs, %d subnormal state values\n", "",
+			            (unsigned long long)report.subnormalOutputs, report.subnormalState);
+		}
+		delete module;
+	}
+	return 0;
+}
@@ -0,0 +1,62 @@
+// Edge scheduling regression test
+// VcoEngine skips wrap and PWM detection for samples it predicts to be
+// edge-free. At the 0.1 Hz frequency clamp and high sample rates, deltaPhase
+// is a few ulps of the phase, so rounding in `phase += deltaPhase` is larger
+// than the prediction's frequency margin. A missed wrap leaves the phase (and
+// the saw) above 1 and drops the wrap's MinBLEP.
+
+#include "VoiceBank.hpp"
+#include <cstdio>
+
+
+static uint32_t rngState = 0x2545f491u;
+
+static float uniform() {
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 17;
+	rngState ^= rngState << 5;
+	return (rngState >> 8) * (1.f / 16777216.f);
+}
+
+// Runs one group of four low-frequency voices from random phases in [0.5, 1),
+// where an ulp of the phase is largest; returns the number of failures
+static int run(float sampleRate, float_4 freq, int samples) {
+	VcoEngine* vco = new VcoEngine;
+	for (int i = 0; i < 4; i++)
+		vco->phase[0][i] = 0.5f + 0.5f * uniform();
+	float sampleTime = 1.f / sampleRate;
+	int wraps = 0, failures = 0;
+	for (int s = 0; s < samples; s++) {
+		float_4 saw, sqr, tri, sine;
+		int wrapMask, fallMask;
+		vco->process(0, freq, sampleTime, 0.5f, saw, sqr, tri, sine, wrapMask, fallMask);
+		for (int i = 0; i < 4; i++) {
+			wraps += (wrapMask >> i) & 1;
+			// Wrapped late: the wrap was detected with the old phase already past 1
+			bool late = ((wrapMask >> i) & 1) && vco->oldPhase[0][i] >= 1.f;
+			// (the saw may round a few ulps above 1 right after a detected wrap)
+			if (vco->phase[0][i] >= 1.f || saw[i] > 1.f + 1e-5f || late) {
+				if (failures < 10) {
+					std::printf("FAIL %g Hz at %g Hz, sample %d: phase %.9g, old phase %.9g, saw %.9g\n",
+					            freq[i], sampleRate, s, vco->phase[0][i], vco->oldPhase[0][i], saw[i]);
+				}
+				failures++;
+			}
+		}
+	}
+	delete vco;
+	std::printf("%g Hz: %d wraps, %d failures\n", sampleRate, wraps, failures);
+	return failures;
+}
+
+int main() {
+	int failures = 0;
+	for (float sampleRate : {176400.f, 192000.f}) {
+		// The frequency clamp, and a few rates whose deltaPhase rounds differently
+		float_4 freq(0.1f, 0.13f, 0.37f, 1.1f);
+		for (int pass = 0; pass < 4; pass++)
+			failures += run(sampleRate, freq, 2000000);
+	}
+	std::printf("%s\n", failures ? "Edge scheduling FAILED" : "Edge scheduling OK");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,474 @@
+// Offline DSP quality tests
+// Renders the oscillator core (VoiceBank.hpp) without the engine, measures each
+// render with a Blackman-Harris windowed FFT and compares the metrics against
+// tests/baselines/quality.json:
+//   aliasingDb  non-harmonic power relative to harmonic power (lower is better)
+//   snrDb       ideal harmonic power relative to the error against the ideal
+//               band-limited spectrum (higher is better)
+//   dc          mean output in volts
+//   pitchCents  measured minus expected pitch, from the interpolated peak of
+//               a harmonic near 1 kHz
+// A metric that is worse than its baseline by more than its tolerance fails
+// the run. The file records the Rack SDK it was generated with (the metrics
+// depend on its SIMD math); baselines from another SDK fail the run too.
+// Usage: quality [--update] <baseline.json>
+
+#include "VoiceBank.hpp"
+#include <cctype>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+static constexpr int FFT_SIZE = 1 << 16;
+static constexpr int LOBE_BINS = 4;  // Blackman-Harris main lobe half-width
+
+static constexpr double TOLERANCE_ALIASING_DB = 1.0;
+static constexpr double TOLERANCE_SNR_DB = 1.0;
+static constexpr double TOLERANCE_DC = 1e-3;
+static constexpr double TOLERANCE_PITCH_CENTS = 0.1;
+
+// Metrics of one render; NaN = not measured
+struct Metrics {
+	double aliasingDb = NAN;
+	double snrDb = NAN;
+	double dc = NAN;
+	double pitchCents = NAN;
+};
+
+enum Waveform {
+	SAW,
+	SQUARE,
+	TRIANGLE,
+	MIX,  // Module output stage, no ideal spectrum
+};
+
+// Ideal amplitude of harmonic k for a unit waveform
+static double idealAmplitude(Waveform waveform, int k) {
+	switch (waveform) {
+		case SAW: return 2.0 / (M_PI * k);
+		case SQUARE: return (k % 2) ? 4.0 / (M_PI * k) : 0.0;
+		case TRIANGLE: return (k % 2) ? 8.0 / (M_PI * M_PI * k * k) : 0.0;
+		default: return 0.0;
+	}
+}
+
+
+// In-place iterative radix-2 FFT
+static void fft(std::vector<std::complex<double>>& x) {
+	int n = (int)x.size();
+	for (int i = 1, j = 0; i < n; i++) {
+		int bit = n >> 1;
+		for (; j & bit; bit >>= 1)
+			j ^= bit;
+		j ^= bit;
+		if (i < j)
+			std::swap(x[i], x[j]);
+	}
+	for (int len = 2; len <= n; len <<= 1) {
+		std::complex<double> w(std::cos(-2.0 * M_PI / len), std::sin(-2.0 * M_PI / len));
+		for (int i = 0; i < n; i += len) {
+			std::complex<double> wk(1.0, 0.0);
+			for (int j = 0; j < len / 2; j++) {
+				std::complex<double> u = x[i + j];
+				std::complex<double> v = x[i + j + len / 2] * wk;
+				x[i + j] = u + v;
+				x[i + j + len / 2] = u - v;
+				wk *= w;
+			}
+		}
+	}
+}
+
+// signal: FFT_SIZE samples, f0: expected fundamental in Hz
+// gain: ideal waveform scale in the render (for SNR)
+static Metrics measure(const std::vector<float>& signal, Waveform waveform, double f0, double gain,
+                       double sampleRate, bool measurePitch) {
+	const int n = FFT_SIZE;
+	std::vector<std::complex<double>> spectrum(n);
+	double windowPower = 0.0;
+	double sum = 0.0;
+	for (int i = 0; i < n; i++) {
+		double t = 2.0 * M_PI * i / n;
+		double w = 0.35875 - 0.48829 * std::cos(t) + 0.14128 * std::cos(2 * t) - 0.01168 * std::cos(3 * t);
+		windowPower += w * w;
+		sum += signal[i];
+		spectrum[i] = signal[i] * w;
+	}
+	fft(spectrum);
+
+	// Power of a sinusoid per unit of summed |X|^2 over its main lobe
+	double scale = 2.0 / ((double)n * windowPower);
+	double binHz = sampleRate / n;
+	int nyquistBin = n / 2;
+	std::vector<double> power(nyquistBin + 1);
+	for (int b = 0; b <= nyquistBin; b++)
+		power[b] = std::norm(spectrum[b]);
+
+	Metrics m;
+	m.dc = sum / n;
+
+	// Harmonic lobes, error against the ideal amplitudes
+	std::vector<bool> harmonic(nyquistBin + 1, false);
+	for (int b = 0; b <= LOBE_BINS; b++)
+		harmonic[b] = true;  // DC lobe is measured separately
+	double harmonicPower = 0.0, signalPower = 0.0, errorPower = 0.0;
+	for (int k = 1; k * f0 < sampleRate / 2; k++) {
+		int center = (int)std::round(k * f0 / binHz);
+		double lobe = 0.0;
+		for (int b = std::max(0, center - LOBE_BINS); b <= std::min(nyquistBin, center + LOBE_BINS); b++) {
+			if (!harmonic[b])
+				lobe += power[b];
+			harmonic[b] = true;
+		}
+		harmonicPower += lobe;
+		double ideal = gain * idealAmplitude(waveform, k);
+		double amplitude = std::sqrt(2.0 * scale * lobe);
+		signalPower += ideal * ideal / 2.0;
+		errorPower += (amplitude - ideal) * (amplitude - ideal) / 2.0;
+	}
+	double aliasPower = 0.0;
+	for (int b = 0; b <= nyquistBin; b++) {
+		if (!harmonic[b])
+			aliasPower += power[b];
+	}
+	m.aliasingDb = 10.0 * std::log10(std::max(aliasPower, 1e-30) / std::max(harmonicPower, 1e-30));
+	if (waveform != MIX) {
+		errorPower += scale * aliasPower;
+		m.snrDb = 10.0 * std::log10(signalPower / std::max(errorPower, 1e-30));
+	}
+
+	if (measurePitch) {
+		// Highest harmonic up to 1 kHz that the waveform has: more bins per cent
+		int k = std::max(1, (int)(1000.0 / f0));
+		while (k > 1 && (idealAmplitude(waveform, k) == 0.0 && waveform != MIX))
+			k--;
+		int center = (int)std::round(k * f0 / binHz);
+		int peak = center;
+		for (int b = center - 2; b <= center + 2; b++) {
+			if (b > 0 && b < nyquistBin && power[b] > power[peak])
+				peak = b;
+		}
+		// Gaussian interpolation (parabola through the log magnitudes)
+		double a = std::log(power[peak - 1]), b = std::log(power[peak]), c = std::log(power[peak + 1]);
+		double delta = 0.5 * (a - c) / (a - 2.0 * b + c);
+		double measured = (peak + delta) * binHz / k;
+		m.pitchCents = 1200.0 * std::log2(measured / f0);
+	}
+	return m;
+}
+
+
+static const FrequencyTable* tuning() {
+	static FrequencyTable table;
+	static bool built = false;
+	if (!built) {
+		table.build12Tet();
+		built = true;
+	}
+	return &table;
+}
+
+static double pitchFrequency(float volts) {
+	return dsp::FREQ_C4 * std::pow(2.0, (double)volts);
+}
+
+// Raw VcoEngine waveform, one voice
+static Metrics renderWaveform(Waveform waveform, float volts, float sampleRate) {
+	VcoEngine* vco = new VcoEngine;
+	float sampleTime = 1.f / sampleRate;
+	float_4 freq = (float)pitchFrequency(volts);
+	std::vector<float> signal(FFT_SIZE);
+	const int settle = 4096;  // Longer than any MinBLEP kernel
+	for (int s = -settle; s < FFT_SIZE; s++) {
+		float_4 saw, sqr, tri, sine;
+		int wrapMask, fallMask;
+		vco->process(0, freq, sampleTime, 0.5f, saw, sqr, tri, sine, wrapMask, fallMask);
+		float out = (waveform == SAW) ? saw[0] : (waveform == SQUARE) ? sqr[0] : tri[0];
+		if (s >= 0)
+			signal[s] = out;
+	}
+	delete vco;
+	return measure(signal, waveform, pitchFrequency(volts), 1.0, sampleRate, true);
+}
+
+// Voice controls as the module sets them with both octave switches at 0 and
+// VCO2 an octave up, so every render is periodic in the VCO1 frequency
+static void initControls(FrameControls& ctl, float volts) {
+	std::memset(&ctl, 0, sizeof(ctl));
+	ctl.channels = 1;
+	for (int lane = 0; lane < 16; lane++) {
+		ctl.freqTable[lane] = tuning();
+		ctl.minBlep[lane] = &MINBLEP_KERNELS[MINBLEP_DEFAULT_QUALITY];
+	}
+	ctl.basePitch[0] = volts;
+	ctl.pitchOffset1[0] = FrequencyTable::indexOffset(0.f);
+	ctl.pitchOffset2[0] = FrequencyTable::indexOffset(1.f);
+	ctl.subPitchOffset[0] = FrequencyTable::indexOffset(-1.f);
+	ctl.pwm1[0] = 0.5f;
+	ctl.pwm2[0] = 0.5f;
+	ctl.updateFmSource(1);
+}
+
+// Full voice through the module's output stage (DC filter, soft clip)
+static std::vector<float> renderVoice(const FrameControls& ctl, float sampleRate) {
+	VoiceBank* voices = new VoiceBank;
+	voices->reset();
+	OutputFrame frame;
+	std::vector<float> signal(FFT_SIZE);
+	// Let the 10 Hz DC filter settle
+	int settle = (int)(sampleRate / 2);
+	for (int s = -settle; s < FFT_SIZE; s++) {
+		voices->render(ctl, 1.f / sampleRate, sampleRate, frame);
+		if (s >= 0)
+			signal[s] = frame.audio[0][0];
+	}
+	delete voices;
+	return signal;
+}
+
+// XOR of VCO1 and VCO2 an octave up is a square wave at the VCO1 frequency.
+// The level is kept low so the soft clipper is linear to well below -100 dB.
+static Metrics renderXor(float volts, float sampleRate) {
+	FrameControls ctl;
+	initControls(ctl, volts);
+	const float level = 0.03f;
+	ctl.xorVol[0] = level;
+	// Mixer scale 1/3, output scale 2
+	double gain = level * (1.0 / 3.0) * 2.0;
+	return measure(renderVoice(ctl, sampleRate), SQUARE, pitchFrequency(volts), gain, sampleRate, true);
+}
+
+// sync: 0 = off, 1 = hard, 2 = soft (VCO2 syncs to VCO1)
+static Metrics renderMix(float volts, float fmDepth, int sync, float sampleRate) {
+	FrameControls ctl;
+	initControls(ctl, volts);
+	ctl.saw1Vol[0] = 1.f;
+	ctl.sqr2Vol[0] = 1.f;
+	ctl.fmDepth[0] = fmDepth;
+	ctl.sync2Hard[0] = (sync == 1) ? 0xf : 0;
+	ctl.sync2Soft[0] = (sync == 2) ? 0xf : 0;
+	bool measurePitch = (fmDepth == 0.f && sync == 0);
+	return measure(renderVoice(ctl, sampleRate), MIX, pitchFrequency(volts), 0.0, sampleRate, measurePitch);
+}
+
+
+// Minimal JSON for the baseline file:
+// {"rackSdk": "version", "name": {"metric": number|null, ...}, ...}
+struct JsonReader {
+	std::string text;
+	size_t pos = 0;
+
+	void skip() {
+		while (pos < text.size() && std::isspace((unsigned char)text[pos]))
+			pos++;
+	}
+	bool expect(char c) {
+		skip();
+		if (pos < text.size() && text[pos] == c) {
+			pos++;
+			return true;
+		}
+		return false;
+	}
+	bool string(std::string& out) {
+		if (!expect('"'))
+			return false;
+		size_t end = text.find('"', pos);
+		if (end == std::string::npos)
+			return false;
+		out = text.substr(pos, end - pos);
+		pos = end + 1;
+		return true;
+	}
+	bool number(double& out) {
+		skip();
+		if (text.compare(pos, 4, "null") == 0) {
+			pos += 4;
+			out = NAN;
+			return true;
+		}
+		char* end;
+		out = std::strtod(text.c_str() + pos, &end);
+		if (end == text.c_str() + pos)
+			return false;
+		pos = end - text.c_str();
+		return true;
+	}
+	// Calls field(key) for each key of an object, which parses the value
+	template <typename F>
+	bool object(F field) {
+		if (!expect('{'))
+			return false;
+		if (expect('}'))
+			return true;
+		do {
+			std::string key;
+			if (!string(key) || !expect(':') || !field(key))
+				return false;
+		} while (expect(','));
+		return expect('}');
+	}
+};
+
+static const char* SDK_KEY = "rackSdk";
+
+static bool readBaselines(const std::string& path, std::string& sdk, std::map<std::string, Metrics>& baselines) {
+	std::ifstream file(path);
+	if (!file)
+		return false;
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	JsonReader reader;
+	reader.text = buffer.str();
+	return reader.object([&](const std::string& name) {
+		if (name == SDK_KEY)
+			return reader.string(sdk);
+		Metrics& m = baselines[name];
+		return reader.object([&](const std::string& metric) {
+			double value;
+			if (!reader.number(value))
+				return false;
+			if (metric == "aliasingDb") m.aliasingDb = value;
+			else if (metric == "snrDb") m.snrDb = value;
+			else if (metric == "dc") m.dc = value;
+			else if (metric == "pitchCents") m.pitchCents = value;
+			return true;
+		});
+	});
+}
+
+static std::string jsonNumber(double value, const char* format) {
+	if (std::isnan(value))
+		return "null";
+	char buffer[32];
+	std::snprintf(buffer, sizeof(buffer), format, value);
+	return buffer;
+}
+
+static bool writeBaselines(const std::string& path, const std::vector<std::pair<std::string, Metrics>>& results) {
+	std::ofstream file(path);
+	if (!file)
+		return false;
+	file << "{\n";
+	file << "\t\"" << SDK_KEY << "\": \"" << APP_VERSION << "\"" << (results.empty() ? "" : ",") << "\n";
+	for (size_t i = 0; i < results.size(); i++) {
+		const Metrics& m = results[i].second;
+		file << "\t\"" << results[i].first << "\": {"
+		     << "\"aliasingDb\": " << jsonNumber(m.aliasingDb, "%.2f")
+		     << ", \"snrDb\": " << jsonNumber(m.snrDb, "%.2f")
+		     << ", \"dc\": " << jsonNumber(m.dc, "%.6f")
+		     << ", \"pitchCents\": " << jsonNumber(m.pitchCents, "%.4f")
+		     << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+	}
+	file << "}\n";
+	return true;
+}
+
+// True if `value` is worse than `baseline` by more than `tolerance`
+// higherIsBetter: direction of the metric; magnitude: compare absolute values
+static bool regressed(double value, double baseline, double tolerance, bool higherIsBetter, bool magnitude) {
+	if (std::isnan(value) || std::isnan(baseline))
+		return std::isnan(value) != std::isnan(baseline);
+	if (magnitude) {
+		value = std::fabs(value);
+		baseline = std::fabs(baseline);
+	}
+	return higherIsBetter ? (value < baseline - tolerance) : (value > baseline + tolerance);
+}
+
+
+int main(int argc, char** argv) {
+	bool update = false;
+	std::string path = "tests/baselines/quality.json";
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--update")
+			update = true;
+		else
+			path = arg;
+	}
+
+	std::vector<std::pair<std::string, Metrics>> results;
+	const float sampleRates[] = {44100.f, 48000.f, 96000.f};
+	const float pitches[] = {-4.f, -2.f, 0.f, 2.f, 4.f, 5.f};
+	const char* waveformNames[] = {"saw", "square", "tri"};
+	const float fmDepths[] = {0.f, 0.5f, 1.f, 2.f};
+	const char* syncNames[] = {"off", "hard", "soft"};
+	for (float sampleRate : sampleRates) {
+		for (float volts : pitches) {
+			for (int w = 0; w < 3; w++) {
+				std::string name = string::f("%s %gHz %+gV", waveformNames[w], sampleRate, volts);
+				results.push_back({name, renderWaveform((Waveform)w, volts, sampleRate)});
+			}
+			results.push_back({string::f("xor %gHz %+gV", sampleRate, volts), renderXor(volts, sampleRate)});
+		}
+		for (float volts : {-2.f, 0.f, 2.f}) {
+			for (float fmDepth : fmDepths) {
+				for (int sync = 0; sync < 3; sync++) {
+					std::string name = string::f("mix %gHz %+gV fm %g sync %s", sampleRate, volts, fmDepth, syncNames[sync]);
+					results.push_back({name, renderMix(volts, fmDepth, sync, sampleRate)});
+				}
+			}
+		}
+	}
+
+	if (update) {
+		if (!writeBaselines(path, results)) {
+			std::fprintf(stderr, "Could not write %s\n", path.c_str());
+			return 1;
+		}
+		std::printf("Wrote %d baselines to %s\n", (int)results.size(), path.c_str());
+		return 0;
+	}
+
+	std::string sdk;
+	std::map<std::string, Metrics> baselines;
+	if (!readBaselines(path, sdk, baselines)) {
+		std::fprintf(stderr, "Could not read %s (run with --update to create it)\n", path.c_str());
+		return 1;
+	}
+	if (sdk != APP_VERSION) {
+		std::printf("FAIL %s was generated with Rack SDK %s, this build links %s: "
+		            "run make test-baselines against the SDK CI uses and commit the file\n",
+		            path.c_str(), sdk.empty() ? "(unknown)" : sdk.c_str(), APP_VERSION.c_str());
+		return 1;
+	}
+	int failures = 0;
+	for (const auto& result : results) {
+		const std::string& name = result.first;
+		const Metrics& m = result.second;
+		auto it = baselines.find(name);
+		if (it == baselines.end()) {
+			std::printf("FAIL %s: no baseline\n", name.c_str());
+			failures++;
+			continue;
+		}
+		const Metrics& b = it->second;
+		struct {
+			const char* metric;
+			double value, baseline, tolerance;
+			bool higherIsBetter, magnitude;
+		} checks[] = {
+			{"aliasingDb", m.aliasingDb, b.aliasingDb, TOLERANCE_ALIASING_DB, false, false},
+			{"snrDb", m.snrDb, b.snrDb, TOLERANCE_SNR_DB, true, false},
+			{"dc", m.dc, b.dc, TOLERANCE_DC, false, true},
+			{"pitchCents", m.pitchCents, b.pitchCents, TOLERANCE_PITCH_CENTS, false, true},
+		};
+		for (const auto& check : checks) {
+			if (regressed(check.value, check.baseline, check.tolerance, check.higherIsBetter, check.magnitude)) {
+				std::printf("FAIL %s: %s %g (baseline %g, tolerance %g)\n",
+				            name.c_str(), check.metric, check.value, check.baseline, check.tolerance);
+				failures++;
+			}
+		}
+	}
+	std::printf("%d renders, %d regressions\n", (int)results.size(), failures);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,149 @@
+// Headless capture replay
+// Loads .hqcv captures into a HydraQuartetVCO outside any engine or window,
+// drives process() through every recorded frame and checks the outputs of
+// each frame against the recorded FNV-1a hash.
+//   replay <capture.hqcv>...   replay existing captures
+//   replay                     record a set of patches (per-sample, block,
+//                              internal rate, stress scenario) into the
+//                              binary's directory, then replay each one in a
+//                              fresh module
+// Fails on a load error, a mismatch or an empty capture.
+
+// The module is defined in its own translation unit: include it whole
+#include "HydraQuartetVCO.cpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+Plugin* pluginInstance = nullptr;
+
+typedef HydraQuartetVCO Vco;
+
+struct Scenario {
+	const char* name;
+	float sampleRate;
+	int blockSize;
+	bool internalRate;
+	int stressScenario;  // Runs the profiler when not STRESS_OFF
+};
+
+// Modulated inputs with some of everything: chords, gates, PWM and FM CV
+static void driveInputs(Vco* module, int64_t frame, float sampleTime) {
+	float t = frame * sampleTime;
+	Vco::overrideInputChannels(module->inputs[Vco::VOCT_INPUT], 4);
+	Vco::overrideInputChannels(module->inputs[Vco::GATE_INPUT], 4);
+	for (int c = 0; c < 4; c++) {
+		module->inputs[Vco::VOCT_INPUT].setVoltage(0.25f * c + 0.5f * std::sin(2.f * float(M_PI) * 0.7f * t), c);
+		bool gate = std::fmod(t * (1.f + 0.5f * c), 1.f) < 0.6f;
+		module->inputs[Vco::GATE_INPUT].setVoltage(gate ? 10.f : 0.f, c);
+	}
+	Vco::overrideInputChannels(module->inputs[Vco::PWM1_INPUT], 1);
+	module->inputs[Vco::PWM1_INPUT].setVoltage(4.f * std::sin(2.f * float(M_PI) * 3.f * t));
+	Vco::overrideInputChannels(module->inputs[Vco::FM_INPUT], 1);
+	module->inputs[Vco::FM_INPUT].setVoltage(2.f + 2.f * std::sin(2.f * float(M_PI) * 0.3f * t));
+}
+
+// Record one second of a scenario; false if nothing could be recorded
+static bool recordScenario(const Scenario& scenario, const std::string& path) {
+	Vco* module = new Vco;
+	module->params[Vco::SAW1_PARAM].setValue(3.f);
+	module->params[Vco::SQR2_PARAM].setValue(2.f);
+	module->params[Vco::XOR_PARAM].setValue(1.f);
+	module->params[Vco::SUB_LEVEL_PARAM].setValue(1.f);
+	module->params[Vco::VIBRATO1_PARAM].setValue(0.3f);
+	module->params[Vco::VIBRATO_SPREAD_PARAM].setValue(0.5f);
+	module->blockSize = scenario.blockSize;
+	module->internalRate = scenario.internalRate;
+	module->profiler.enabled = (scenario.stressScenario != Vco::STRESS_OFF);
+	module->stressScenario = scenario.stressScenario;
+
+	std::string error;
+	if (!module->startRecording(path, scenario.sampleRate, error)) {
+		std::printf("FAIL %s: %s\n", scenario.name, error.c_str());
+		delete module;
+		return false;
+	}
+	Module::ProcessArgs args;
+	args.sampleRate = scenario.sampleRate;
+	args.sampleTime = 1.f / scenario.sampleRate;
+	args.frame = 0;
+	for (int i = 0; i < (int)scenario.sampleRate; i++) {
+		driveInputs(module, args.frame, args.sampleTime);
+		module->process(args);
+		args.frame++;
+	}
+	// The next frame publishes the last chunk; the destructor waits for the writer
+	module->recorder.stop();
+	module->process(args);
+	uint64_t frames = module->recorder.framesRecorded.load();
+	bool overrun = module->recorder.overrun.load();
+	delete module;
+	if (frames == 0 || overrun) {
+		std::printf("FAIL %s: %s\n", scenario.name, overrun ? "recording overran" : "nothing recorded");
+		return false;
+	}
+	return true;
+}
+
+// Replay a capture in a fresh module with the engine settings it was made at
+static bool replayCapture(const std::string& path) {
+	Vco* module = new Vco;
+	std::string error, warning;
+	if (!module->startReplay(path, 0.f, error, warning)) {
+		std::printf("FAIL %s: %s\n", path.c_str(), error.c_str());
+		delete module;
+		return false;
+	}
+	if (!warning.empty())
+		std::printf("%s: %s\n", path.c_str(), warning.c_str());
+
+	Module::ProcessArgs args;
+	args.sampleRate = module->replay.header.sampleRate;
+	args.sampleTime = 1.f / args.sampleRate;
+	args.frame = 0;
+	while (module->replayState.load() != Vco::REPLAY_DONE) {
+		module->process(args);
+		args.frame++;
+	}
+
+	const CvReplay& replay = module->replay;
+	bool ok = (replay.frames > 0 && replay.mismatches == 0);
+	std::printf("%s %s: %llu frames at %g Hz, %llu mismatches", ok ? "OK" : "FAIL", path.c_str(),
+	            (unsigned long long)replay.frames, replay.header.sampleRate, (unsigned long long)replay.mismatches);
+	if (replay.mismatches > 0)
+		std::printf(" (first at frame %lld)", (long long)replay.firstMismatch);
+	std::printf("\n");
+	delete module;
+	return ok;
+}
+
+int main(int argc, char** argv) {
+	std::vector<std::string> paths;
+	for (int i = 1; i < argc; i++)
+		paths.push_back(argv[i]);
+
+	int failures = 0;
+	if (paths.empty()) {
+		std::string dir = argv[0];
+		dir = dir.substr(0, dir.find_last_of('/') + 1);
+		const Scenario scenarios[] = {
+			{"per-sample", 48000.f, 0, false, Vco::STRESS_OFF},
+			{"block", 48000.f, 32, false, Vco::STRESS_OFF},
+			{"internal-rate", 192000.f, 0, true, Vco::STRESS_OFF},
+			{"stress", 48000.f, 0, false, Vco::STRESS_ALL},
+		};
+		for (const Scenario& scenario : scenarios) {
+			std::string path = dir + "replay-" + scenario.name + ".hqcv";
+			if (recordScenario(scenario, path))
+				paths.push_back(path);
+			else
+				failures++;
+		}
+	}
+
+	for (const std::string& path : paths)
+		failures += !replayCapture(path);
+	std::printf("%s\n", failures ? "Replay FAILED" : "Replay OK");
+	return failures ? 1 : 0;
+}